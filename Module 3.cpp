@@ -9,15 +9,406 @@
 #include <cmath>
 #include <limits>
 #include <map>
+#include <queue>
+#include <sstream>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <cstring>
+#include <cstdio>
+#include <string_view>
+#include <charconv>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <random>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 // Define the flood threshold for risk zones
 const float FLOOD_THRESHOLD = 5.0;
 
+// Marks an empty slot or a removed place
+const std::size_t NO_PLACE = std::numeric_limits<std::size_t>::max();
+
+// Count, sum, minimum and maximum of the values in a stretch of a time series
+struct SeriesSummary
+{
+    std::size_t points = 0;
+    std::int64_t sum = 0;
+    std::int32_t min = 0;
+    std::int32_t max = 0;
+
+    void add(std::int32_t value)
+    {
+        min = points == 0 ? value : std::min(min, value);
+        max = points == 0 ? value : std::max(max, value);
+        sum += value;
+        ++points;
+    }
+
+    void add(const SeriesSummary &other)
+    {
+        if (other.points == 0)
+        {
+            return;
+        }
+        min = points == 0 ? other.min : std::min(min, other.min);
+        max = points == 0 ? other.max : std::max(max, other.max);
+        sum += other.sum;
+        points += other.points;
+    }
+};
+
+// Per-minute counts for one place, compressed in blocks of BLOCK_POINTS
+// points. Inside a block each point stores the change from the previous value
+// as a zigzag varint, with its low bit saying whether a varint gap in minutes
+// follows; a point one minute after the last needs no gap, so a steady
+// minute-by-minute stream takes about one byte a point. Every sealed block
+// keeps a summary, and range queries use it for blocks that lie wholly inside
+// the range, decoding only the blocks at its two ends. New points gather
+// uncompressed in the tail until a block fills.
+class RescueTimeSeries
+{
+private:
+    static const std::size_t BLOCK_POINTS = 128;
+    // Longest gap accepted when reading a series back, about two million years
+    static constexpr std::uint64_t MAX_GAP_MINUTES = std::uint64_t(1) << 40;
+
+    struct Block
+    {
+        std::int64_t firstMinute;
+        std::int64_t lastMinute;
+        std::size_t offset;
+        SeriesSummary summary;
+    };
+
+    std::vector<Block> blocks;
+    std::vector<std::uint8_t> bytes;
+    std::vector<std::pair<std::int64_t, std::int32_t>> tail;
+    // Serialized points still in a mapped snapshot, decoded on first use
+    std::string_view packed;
+
+    std::size_t pointCount() const
+    {
+        return blocks.size() * BLOCK_POINTS + tail.size();
+    }
+
+    // Decode points attached from a snapshot, dropping them if malformed
+    void unpack()
+    {
+        if (packed.empty())
+        {
+            return;
+        }
+        const char *p = packed.data(), *end = p + packed.size();
+        packed = {};
+        if (!deserialize(p, end) || p != end)
+        {
+            clear();
+            std::cerr << "Discarding a malformed rescue history.\n";
+        }
+    }
+
+    template <typename Bytes>
+    static void putVarint(Bytes &out, std::uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    static std::uint64_t getVarint(const std::uint8_t *&p)
+    {
+        std::uint64_t value = 0;
+        for (int shift = 0;; shift += 7)
+        {
+            std::uint8_t byte = *p++;
+            value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if (byte < 0x80)
+            {
+                return value;
+            }
+        }
+    }
+
+    // Read a varint from untrusted bytes; false if it runs past end
+    static bool getVarint(const char *&p, const char *end, std::uint64_t &value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64 && p < end; shift += 7)
+        {
+            std::uint8_t byte = static_cast<std::uint8_t>(*p++);
+            value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if (byte < 0x80)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static std::uint64_t zigzag(std::int64_t value)
+    {
+        return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+    }
+
+    static std::int64_t unzigzag(std::uint64_t value)
+    {
+        return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+    }
+
+    // Compress the tail into a new block
+    void seal()
+    {
+        Block block{tail.front().first, tail.back().first, bytes.size(), SeriesSummary()};
+        std::int64_t previousMinute = block.firstMinute;
+        std::int32_t previousValue = 0;
+        for (const auto &[minute, value] : tail)
+        {
+            std::uint64_t gap = static_cast<std::uint64_t>(minute - previousMinute);
+            putVarint(bytes, zigzag(static_cast<std::int64_t>(value) - previousValue) << 1 | (gap != 1));
+            if (gap != 1)
+            {
+                putVarint(bytes, gap);
+            }
+            block.summary.add(value);
+            previousMinute = minute;
+            previousValue = value;
+        }
+        blocks.push_back(block);
+        tail.clear();
+    }
+
+    // Decode a sealed block, calling visit(minute, value) for each point
+    template <typename Visit>
+    void decode(const Block &block, const Visit &visit) const
+    {
+        const std::uint8_t *p = bytes.data() + block.offset;
+        std::int64_t minute = block.firstMinute;
+        std::int32_t value = 0;
+        for (std::size_t i = 0; i < block.summary.points; ++i)
+        {
+            std::uint64_t word = getVarint(p);
+            minute += (word & 1) ? static_cast<std::int64_t>(getVarint(p)) : 1;
+            value += static_cast<std::int32_t>(unzigzag(word >> 1));
+            visit(minute, value);
+        }
+    }
+
+public:
+    // Add a count at a minute. Points must arrive in time order; a point at
+    // or before the latest minute is added to the latest point. A full tail is
+    // sealed only when a later minute arrives, so the latest point stays open.
+    void append(std::int64_t minute, std::int32_t value)
+    {
+        unpack();
+        if (!tail.empty() && minute <= tail.back().first)
+        {
+            tail.back().second += value;
+            return;
+        }
+        if (tail.size() == BLOCK_POINTS)
+        {
+            seal();
+        }
+        tail.emplace_back(minute, value);
+    }
+
+    // Summary of the points with from <= minute <= to
+    SeriesSummary range(std::int64_t from, std::int64_t to)
+    {
+        unpack();
+        SeriesSummary result;
+        auto block = std::lower_bound(blocks.begin(), blocks.end(), from,
+                                      [](const Block &b, std::int64_t minute) { return b.lastMinute < minute; });
+        for (; block != blocks.end() && block->firstMinute <= to; ++block)
+        {
+            if (block->firstMinute >= from && block->lastMinute <= to)
+            {
+                result.add(block->summary);
+                continue;
+            }
+            decode(*block, [&](std::int64_t minute, std::int32_t value)
+            {
+                if (minute >= from && minute <= to)
+                {
+                    result.add(value);
+                }
+            });
+        }
+        for (const auto &[minute, value] : tail)
+        {
+            if (minute >= from && minute <= to)
+            {
+                result.add(value);
+            }
+        }
+        return result;
+    }
+
+    void clear()
+    {
+        blocks.clear();
+        bytes.clear();
+        tail.clear();
+        packed = {};
+    }
+
+    // Append the series to out for a snapshot: the point count, the minute
+    // before the first point, then every point coded as inside a block
+    void serialize(std::string &out) const
+    {
+        if (!packed.empty())
+        {
+            out.append(packed);
+            return;
+        }
+        putVarint(out, pointCount());
+        if (pointCount() == 0)
+        {
+            return;
+        }
+        std::int64_t previousMinute = (blocks.empty() ? tail.front().first : blocks.front().firstMinute) - 1;
+        std::int32_t previousValue = 0;
+        auto put = [&](std::int64_t minute, std::int32_t value)
+        {
+            std::uint64_t gap = static_cast<std::uint64_t>(minute - previousMinute);
+            putVarint(out, zigzag(static_cast<std::int64_t>(value) - previousValue) << 1 | (gap != 1));
+            if (gap != 1)
+            {
+                putVarint(out, gap);
+            }
+            previousMinute = minute;
+            previousValue = value;
+        };
+        putVarint(out, zigzag(previousMinute));
+        for (const auto &block : blocks)
+        {
+            decode(block, put);
+        }
+        for (const auto &[minute, value] : tail)
+        {
+            put(minute, value);
+        }
+    }
+
+    // Use serialized points that outlive the series (a mapped snapshot); they
+    // are decoded the first time the series is read or extended
+    void attach(std::string_view serialized)
+    {
+        clear();
+        packed = serialized;
+    }
+
+    // Replace the series with one written by serialize, advancing p. False if
+    // the bytes up to end do not hold a well-formed series.
+    bool deserialize(const char *&p, const char *end)
+    {
+        clear();
+        std::uint64_t points, word, gap = 1;
+        if (!getVarint(p, end, points))
+        {
+            return false;
+        }
+        if (points == 0)
+        {
+            return true;
+        }
+        if (!getVarint(p, end, word))
+        {
+            return false;
+        }
+        std::int64_t minute = unzigzag(word), value = 0;
+        for (std::uint64_t i = 0; i < points; ++i)
+        {
+            if (!getVarint(p, end, word) || ((word & 1) && !getVarint(p, end, gap)))
+            {
+                return false;
+            }
+            std::int64_t change = unzigzag(word >> 1);
+            if ((word & 1) && (gap == 0 || gap > MAX_GAP_MINUTES))
+            {
+                return false;
+            }
+            if (change < static_cast<std::int64_t>(INT32_MIN) - value || change > static_cast<std::int64_t>(INT32_MAX) - value)
+            {
+                return false;
+            }
+            minute += (word & 1) ? static_cast<std::int64_t>(gap) : 1;
+            value += change;
+            append(minute, static_cast<std::int32_t>(value));
+        }
+        return true;
+    }
+
+    std::size_t size()
+    {
+        unpack();
+        return pointCount();
+    }
+
+    // Bytes of heap memory held by the series; points still in a mapped
+    // snapshot take none
+    std::size_t memoryUsage() const
+    {
+        return blocks.capacity() * sizeof(Block) + bytes.capacity() + tail.capacity() * sizeof(tail[0]);
+    }
+};
+
+// Minutes since the Unix epoch now
+std::int64_t currentMinute()
+{
+    return std::chrono::duration_cast<std::chrono::minutes>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Parse a local "YYYY-MM-DD HH:MM" time into minutes since the epoch
+bool parseMinute(const std::string &text, std::int64_t &minute)
+{
+    std::tm time = {};
+    std::istringstream in(text);
+    in >> std::get_time(&time, "%Y-%m-%d %H:%M");
+    if (in.fail())
+    {
+        return false;
+    }
+    time.tm_isdst = -1;
+    std::time_t seconds = std::mktime(&time);
+    if (seconds == -1)
+    {
+        return false;
+    }
+    minute = seconds / 60;
+    return true;
+}
+
+// Format minutes since the epoch as a local "YYYY-MM-DD HH:MM" time
+std::string formatMinute(std::int64_t minute)
+{
+    std::time_t seconds = static_cast<std::time_t>(minute * 60);
+    std::ostringstream out;
+    out << std::put_time(std::localtime(&seconds), "%Y-%m-%d %H:%M");
+    return out.str();
+}
+
 // Structure to represent a point in the map
 struct Place
 {
-     // Name of the place
-    std::string name;
+     // Name of the place: a view into the mapped snapshot it was loaded from,
+     // or into ownedName
+    std::string_view name;
+    // Heap copy of a name that did not come from a snapshot; it stays put
+    // when the Place is moved
+    std::shared_ptr<const std::string> ownedName;
      // Elevation of the place
     float elevation;
      // Flood depth at the place
@@ -33,215 +424,2528 @@ struct Place
     int injured;
     // Number of deaths
     int deaths;
-
-    Place(const std::string &name = "", float elevation = 0)
-        : name(name), elevation(elevation), floodDepth(0), rescued(0), maleRescued(0), femaleRescued(0), injured(0), deaths(0) {}
+    // Latitude and longitude in degrees
+    double latitude;
+    double longitude;
+    // Stable ID assigned by the map; unchanged by sorting and removals
+    std::size_t id;
+    // People rescued per minute, keyed by minutes since the Unix epoch
+    RescueTimeSeries rescueHistory;
+
+    Place(const std::string &name = "", float elevation = 0, double latitude = 0, double longitude = 0)
+        : ownedName(name.empty() ? nullptr : std::make_shared<const std::string>(name)), elevation(elevation), floodDepth(0),
+          rescued(0), maleRescued(0), femaleRescued(0), injured(0), deaths(0), latitude(latitude), longitude(longitude), id(NO_PLACE)
+    {
+        if (ownedName)
+        {
+            this->name = *ownedName;
+        }
+    }
 
 };
 
-// Class to represent the flood risk map
-class FloodRiskMap
+// Local map plane: an equirectangular projection about the city's latitude,
+// accurate to well under 1% over the extent of a city
+const double MAP_REFERENCE_LATITUDE = 19.0;
+const double KM_PER_DEGREE_LATITUDE = 110.574;
+const double KM_PER_DEGREE_LONGITUDE = 111.320 * std::cos(MAP_REFERENCE_LATITUDE * M_PI / 180.0);
+
+// Position of a place on the local map plane, in kilometers
+std::pair<double, double> mapPosition(const Place &place)
+{
+    return {place.longitude * KM_PER_DEGREE_LONGITUDE, place.latitude * KM_PER_DEGREE_LATITUDE};
+}
+
+// Two-dimensional k-d tree over place positions for nearest, k-nearest and
+// radius queries. Inserts attach a new leaf and removals leave a tombstone;
+// the tree rebuilds itself balanced when it grows too deep or too many nodes
+// are dead, so updates and queries stay O(log n) amortized.
+class PlaceKdTree
 {
 private:
-    // List of places
-    std::vector<Place> places;
+    struct Node
+    {
+        double x, y;
+        std::size_t place;
+        int left = -1, right = -1;
+        int axis = 0;
+        bool removed = false;
+    };
+
+    std::vector<Node> nodes;
+    int root = -1;
+    std::size_t liveCount = 0;
+
+    int buildRange(std::vector<Node> &source, std::size_t begin, std::size_t end, int depth)
+    {
+        if (begin >= end)
+        {
+            return -1;
+        }
+        std::size_t middle = begin + (end - begin) / 2;
+        int axis = depth % 2;
+        std::nth_element(source.begin() + begin, source.begin() + middle, source.begin() + end,
+                         [axis](const Node &a, const Node &b) { return axis == 0 ? a.x < b.x : a.y < b.y; });
+
+        int index = static_cast<int>(nodes.size());
+        nodes.push_back(source[middle]);
+        nodes[index].axis = axis;
+        int left = buildRange(source, begin, middle, depth + 1);
+        int right = buildRange(source, middle + 1, end, depth + 1);
+        nodes[index].left = left;
+        nodes[index].right = right;
+        return index;
+    }
 
-    void initializePlaces()
+    // Rebuild a balanced tree from the live nodes
+    void rebuild()
     {
-        // Initialize places with sample data
-        places = {
-            {"Colaba", 3.0}, {"Marine Drive", 2.5}, {"Dadar", 6.0}, {"Bandra", 7.0},
-            {"Andheri", 8.0}, {"Borivali", 10.0}, {"Thane", 15.0}, {"Navi Mumbai", 5.0},
-            {"Panvel", 4.0}, {"Vasai", 6.5}, {"Virar", 12.0}, {"Kalyan", 7.5}};
+        std::vector<Node> source;
+        source.reserve(liveCount);
+        for (const auto &node : nodes)
+        {
+            if (!node.removed)
+            {
+                source.push_back({node.x, node.y, node.place});
+            }
+        }
+        nodes.clear();
+        nodes.reserve(source.size());
+        root = buildRange(source, 0, source.size(), 0);
+        liveCount = source.size();
+    }
+
+    int find(int index, std::size_t place, double x, double y) const
+    {
+        while (index >= 0)
+        {
+            const Node &node = nodes[index];
+            if (!node.removed && node.place == place)
+            {
+                return index;
+            }
+            double query = node.axis == 0 ? x : y, split = node.axis == 0 ? node.x : node.y;
+            if (query == split)
+            {
+                // Equal keys can sit on either side of a balanced split
+                int found = find(node.left, place, x, y);
+                return found >= 0 ? found : find(node.right, place, x, y);
+            }
+            index = query < split ? node.left : node.right;
+        }
+        return -1;
+    }
+
+    template <typename Filter>
+    void nearestFrom(int index, double x, double y, std::size_t k, const Filter &accept,
+                     std::priority_queue<std::pair<double, std::size_t>> &best) const
+    {
+        if (index < 0)
+        {
+            return;
+        }
+        const Node &node = nodes[index];
+        double dx = node.x - x, dy = node.y - y;
+        if (!node.removed && accept(node.place))
+        {
+            double distance = dx * dx + dy * dy;
+            if (best.size() < k)
+            {
+                best.push({distance, node.place});
+            }
+            else if (distance < best.top().first)
+            {
+                best.pop();
+                best.push({distance, node.place});
+            }
+        }
+
+        double split = node.axis == 0 ? dx : dy;
+        nearestFrom(split > 0 ? node.left : node.right, x, y, k, accept, best);
+        if (best.size() < k || split * split < best.top().first)
+        {
+            nearestFrom(split > 0 ? node.right : node.left, x, y, k, accept, best);
+        }
+    }
+
+    template <typename Filter>
+    void radiusFrom(int index, double x, double y, double radius, const Filter &accept,
+                    std::vector<std::pair<double, std::size_t>> &found) const
+    {
+        if (index < 0)
+        {
+            return;
+        }
+        const Node &node = nodes[index];
+        double dx = node.x - x, dy = node.y - y;
+        if (!node.removed && dx * dx + dy * dy <= radius * radius && accept(node.place))
+        {
+            found.push_back({std::sqrt(dx * dx + dy * dy), node.place});
+        }
+
+        double query = node.axis == 0 ? x : y, split = node.axis == 0 ? node.x : node.y;
+        if (query - radius <= split)
+        {
+            radiusFrom(node.left, x, y, radius, accept, found);
+        }
+        if (query + radius >= split)
+        {
+            radiusFrom(node.right, x, y, radius, accept, found);
+        }
     }
 
 public:
-    FloodRiskMap()
+    // Build a balanced tree over places, keyed by place ID
+    void build(const std::vector<Place> &places)
+    {
+        nodes.clear();
+        for (const auto &place : places)
+        {
+            auto [x, y] = mapPosition(place);
+            nodes.push_back({x, y, place.id});
+        }
+        liveCount = nodes.size();
+        rebuild();
+    }
 
+    void insert(std::size_t place, double x, double y)
     {
-        initializePlaces();
+        Node leaf{x, y, place};
+        ++liveCount;
+        if (root < 0)
+        {
+            nodes.push_back(leaf);
+            root = static_cast<int>(nodes.size()) - 1;
+            return;
+        }
+
+        int index = root, depth = 1;
+        while (true)
+        {
+            Node &node = nodes[index];
+            bool goLeft = (node.axis == 0 ? x < node.x : y < node.y);
+            int next = goLeft ? node.left : node.right;
+            if (next < 0)
+            {
+                leaf.axis = (node.axis + 1) % 2;
+                int child = static_cast<int>(nodes.size());
+                if (goLeft)
+                {
+                    node.left = child;
+                }
+                else
+                {
+                    node.right = child;
+                }
+                nodes.push_back(leaf);
+                break;
+            }
+            index = next;
+            ++depth;
+        }
+
+        if (depth > 2 * std::log2(static_cast<double>(liveCount)) + 8)
+        {
+            rebuild();
+        }
     }
 
-    // Identify flood risk zones based on elevation
-    void identifyFloodRiskZones()
+    // Remove a place at a known position; false if it is not in the tree
+    bool erase(std::size_t place, double x, double y)
+    {
+        int index = find(root, place, x, y);
+        if (index < 0)
+        {
+            return false;
+        }
+        nodes[index].removed = true;
+        --liveCount;
+        if (nodes.size() > 2 * liveCount + 16)
+        {
+            rebuild();
+        }
+        return true;
+    }
+
+    // Up to k accepted places nearest (x, y), closest first, with distances
+    template <typename Filter>
+    std::vector<std::pair<double, std::size_t>> nearest(double x, double y, std::size_t k, const Filter &accept) const
+    {
+        std::priority_queue<std::pair<double, std::size_t>> best;
+        if (k > 0)
+        {
+            nearestFrom(root, x, y, k, accept, best);
+        }
+        std::vector<std::pair<double, std::size_t>> result(best.size());
+        for (std::size_t i = result.size(); i-- > 0; best.pop())
+        {
+            result[i] = {std::sqrt(best.top().first), best.top().second};
+        }
+        return result;
+    }
+
+    // Accepted places within radius of (x, y), closest first, with distances
+    template <typename Filter>
+    std::vector<std::pair<double, std::size_t>> withinRadius(double x, double y, double radius, const Filter &accept) const
+    {
+        std::vector<std::pair<double, std::size_t>> found;
+        radiusFrom(root, x, y, radius, accept, found);
+        std::sort(found.begin(), found.end());
+        return found;
+    }
+};
+
+// Open-addressing hash index from place name to place ID.
+// Linear probing over a power-of-two table; each slot keeps the full hash so
+// names are compared only on a hash match. Deletion shifts later entries of
+// the probe run back, so no tombstones accumulate.
+class PlaceNameIndex
+{
+private:
+    struct Slot
+    {
+        std::size_t hash;
+        std::size_t id = NO_PLACE;
+    };
+
+    std::vector<Slot> slots = std::vector<Slot>(16);
+    std::size_t count = 0;
+
+    std::size_t mask() const { return slots.size() - 1; }
+
+    void grow()
+    {
+        std::vector<Slot> old(slots.size() * 2);
+        old.swap(slots);
+        for (const auto &slot : old)
+        {
+            if (slot.id != NO_PLACE)
+            {
+                std::size_t i = slot.hash & mask();
+                while (slots[i].id != NO_PLACE)
+                {
+                    i = (i + 1) & mask();
+                }
+                slots[i] = slot;
+            }
+        }
+    }
+
+    // Slot holding name, or the empty slot ending its probe run
+    template <typename NameOf>
+    std::size_t probe(std::string_view name, std::size_t hash, const NameOf &nameOf) const
+    {
+        std::size_t i = hash & mask();
+        while (slots[i].id != NO_PLACE && !(slots[i].hash == hash && nameOf(slots[i].id) == name))
+        {
+            i = (i + 1) & mask();
+        }
+        return i;
+    }
+
+public:
+    void clear()
+    {
+        slots.assign(16, Slot{});
+        count = 0;
+    }
+
+    void reserve(std::size_t places)
+    {
+        while (slots.size() * 3 < places * 4)
+        {
+            grow();
+        }
+    }
+
+    // ID of the named place, or NO_PLACE; nameOf(id) returns a place's name
+    template <typename NameOf>
+    std::size_t find(std::string_view name, const NameOf &nameOf) const
+    {
+        return slots[probe(name, std::hash<std::string_view>{}(name), nameOf)].id;
+    }
+
+    // Add a name; false if it is already indexed
+    template <typename NameOf>
+    bool insert(std::string_view name, std::size_t id, const NameOf &nameOf)
+    {
+        if ((count + 1) * 4 > slots.size() * 3)
+        {
+            grow();
+        }
+        std::size_t hash = std::hash<std::string_view>{}(name);
+        std::size_t i = probe(name, hash, nameOf);
+        if (slots[i].id != NO_PLACE)
+        {
+            return false;
+        }
+        slots[i] = {hash, id};
+        ++count;
+        return true;
+    }
+
+    template <typename NameOf>
+    void erase(std::string_view name, const NameOf &nameOf)
+    {
+        std::size_t i = probe(name, std::hash<std::string_view>{}(name), nameOf);
+        if (slots[i].id == NO_PLACE)
+        {
+            return;
+        }
+        slots[i].id = NO_PLACE;
+        --count;
+
+        // Move back any entry whose probe run passed through the freed slot
+        for (std::size_t j = (i + 1) & mask(); slots[j].id != NO_PLACE; j = (j + 1) & mask())
+        {
+            std::size_t home = slots[j].hash & mask();
+            if (((j - home) & mask()) >= ((j - i) & mask()))
+            {
+                slots[i] = slots[j];
+                slots[j].id = NO_PLACE;
+                i = j;
+            }
+        }
+    }
+
+    std::size_t slotCount() const
+    {
+        return slots.size();
+    }
+
+    // Append the slot table to out as (hash, id) pairs of 64-bit words, with
+    // each id replaced by idOf(id) and empty slots written as NO_PLACE
+    template <typename IdOf>
+    void exportSlots(std::string &out, const IdOf &idOf) const
+    {
+        for (const auto &slot : slots)
+        {
+            std::uint64_t words[2] = {slot.hash, slot.id == NO_PLACE ? NO_PLACE : idOf(slot.id)};
+            out.append(reinterpret_cast<const char *>(words), sizeof(words));
+        }
+    }
+
+    // Replace the table with slotCount slots written by exportSlots, which
+    // must index exactly the IDs below placeCount; false if they do not
+    bool importSlots(const char *data, std::size_t slotCount, std::size_t placeCount)
+    {
+        if (slotCount < 16 || (slotCount & (slotCount - 1)) != 0 || placeCount * 4 > slotCount * 3)
+        {
+            return false;
+        }
+        std::vector<Slot> imported(slotCount);
+        std::size_t used = 0;
+        for (std::size_t i = 0; i < slotCount; ++i)
+        {
+            std::uint64_t words[2];
+            std::memcpy(words, data + i * sizeof(words), sizeof(words));
+            if (words[1] != NO_PLACE && words[1] >= placeCount)
+            {
+                return false;
+            }
+            imported[i] = {static_cast<std::size_t>(words[0]), static_cast<std::size_t>(words[1])};
+            used += words[1] != NO_PLACE;
+        }
+        if (used != placeCount)
+        {
+            return false;
+        }
+        slots.swap(imported);
+        count = used;
+        return true;
+    }
+};
+
+// Place IDs ordered by elevation, kept as two parallel arrays sorted by
+// (elevation, id). "All places below level L" is one binary search over the
+// contiguous elevation array followed by a contiguous prefix of IDs.
+// An elevation change rotates the entry to its new rank, so the cost is
+// proportional to how far it moves rather than to the number of places.
+class ElevationIndex
+{
+private:
+    std::vector<float> elevations;
+    std::vector<std::size_t> ids;
+
+    // First rank whose (elevation, id) is not less than the given key
+    std::size_t rankOf(float elevation, std::size_t id) const
+    {
+        std::size_t low = 0, high = elevations.size();
+        while (low < high)
+        {
+            std::size_t middle = low + (high - low) / 2;
+            if (elevations[middle] < elevation || (elevations[middle] == elevation && ids[middle] < id))
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+        return low;
+    }
+
+public:
+    void build(const std::vector<Place> &places)
+    {
+        std::vector<std::pair<float, std::size_t>> entries;
+        entries.reserve(places.size());
+        for (const auto &place : places)
+        {
+            entries.push_back({place.elevation, place.id});
+        }
+        std::sort(entries.begin(), entries.end());
+        elevations.resize(entries.size());
+        ids.resize(entries.size());
+        for (std::size_t i = 0; i < entries.size(); ++i)
+        {
+            elevations[i] = entries[i].first;
+            ids[i] = entries[i].second;
+        }
+    }
+
+    void insert(std::size_t id, float elevation)
+    {
+        std::size_t rank = rankOf(elevation, id);
+        elevations.insert(elevations.begin() + rank, elevation);
+        ids.insert(ids.begin() + rank, id);
+    }
+
+    void erase(std::size_t id, float elevation)
+    {
+        std::size_t rank = rankOf(elevation, id);
+        if (rank < ids.size() && ids[rank] == id)
+        {
+            elevations.erase(elevations.begin() + rank);
+            ids.erase(ids.begin() + rank);
+        }
+    }
+
+    // Move a place from its old elevation to a new one
+    void update(std::size_t id, float oldElevation, float newElevation)
+    {
+        std::size_t from = rankOf(oldElevation, id);
+        if (from >= ids.size() || ids[from] != id)
+        {
+            return;
+        }
+
+        std::size_t to = rankOf(newElevation, id);
+        if (to > from)
+        {
+            // The search counted this entry as smaller, so it lands one before
+            std::rotate(elevations.begin() + from, elevations.begin() + from + 1, elevations.begin() + to);
+            std::rotate(ids.begin() + from, ids.begin() + from + 1, ids.begin() + to);
+            elevations[to - 1] = newElevation;
+        }
+        else
+        {
+            std::rotate(elevations.begin() + to, elevations.begin() + from, elevations.begin() + from + 1);
+            std::rotate(ids.begin() + to, ids.begin() + from, ids.begin() + from + 1);
+            elevations[to] = newElevation;
+        }
+    }
+
+    // Number of places strictly below a level; they are ids()[0 .. count)
+    std::size_t countBelow(float level) const
+    {
+        return std::lower_bound(elevations.begin(), elevations.end(), level) - elevations.begin();
+    }
+
+    // Place IDs in ascending elevation
+    const std::vector<std::size_t> &orderedIds() const
+    {
+        return ids;
+    }
+};
+
+// Changes to the rescue counters of one place
+struct RescueCounts
+{
+    int rescued = 0;
+    int males = 0;
+    int females = 0;
+    int injured = 0;
+    int deaths = 0;
+};
+
+// Running totals over all places, kept up to date on every change so the
+// summary views do not have to walk the map
+struct MapAggregates
+{
+    long long rescued = 0;
+    long long males = 0;
+    long long females = 0;
+    long long injured = 0;
+    long long deaths = 0;
+    std::size_t riskZones = 0;
+    double riskZoneElevation = 0;
+};
+
+// Collects rescue reports from many threads at once. Writers add to per-place
+// deltas in one of several shards, so concurrent writers rarely share a lock.
+// Every shard keeps two delta tables, one per epoch. A reader flips the epoch,
+// waits for the few writers still inside the old epoch, then drains the old
+// tables: it sees exactly the reports made before the flip, all fields of
+// each report together, and writers carry on in the new epoch meanwhile.
+class RescueTracker
+{
+private:
+    static const unsigned SHARDS = 16;
+
+    struct alignas(64) Shard
+    {
+        std::mutex mutex[2];
+        std::unordered_map<std::size_t, RescueCounts> deltas[2];
+        std::atomic<unsigned> activeWriters[2] = {0, 0};
+    };
+
+    Shard shards[SHARDS];
+    std::atomic<unsigned> epoch{0};
+    std::atomic<unsigned> nextShard{0};
+    std::mutex readerMutex;
+
+public:
+    // Record one report for a place ID; safe to call from any thread
+    void record(std::size_t id, const RescueCounts &counts)
+    {
+        static thread_local unsigned shardIndex = nextShard.fetch_add(1) % SHARDS;
+        Shard &shard = shards[shardIndex];
+
+        unsigned current;
+        while (true)
+        {
+            current = epoch.load();
+            shard.activeWriters[current].fetch_add(1);
+            if (epoch.load() == current)
+            {
+                break;
+            }
+            // A reader flipped the epoch in between; join the new one
+            shard.activeWriters[current].fetch_sub(1);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex[current]);
+            RescueCounts &delta = shard.deltas[current][id];
+            delta.rescued += counts.rescued;
+            delta.males += counts.males;
+            delta.females += counts.females;
+            delta.injured += counts.injured;
+            delta.deaths += counts.deaths;
+        }
+        shard.activeWriters[current].fetch_sub(1);
+    }
+
+    // Close the current epoch and pass every place's accumulated delta to
+    // apply(id, counts). Returns the number of places that changed.
+    template <typename Apply>
+    std::size_t drain(const Apply &apply)
+    {
+        std::lock_guard<std::mutex> readerLock(readerMutex);
+        unsigned closed = epoch.load();
+        epoch.store(1 - closed);
+
+        std::size_t changed = 0;
+        for (auto &shard : shards)
+        {
+            while (shard.activeWriters[closed].load() != 0)
+            {
+                std::this_thread::yield();
+            }
+            std::lock_guard<std::mutex> lock(shard.mutex[closed]);
+            for (const auto &[id, counts] : shard.deltas[closed])
+            {
+                apply(id, counts);
+                ++changed;
+            }
+            shard.deltas[closed].clear();
+        }
+        return changed;
+    }
+};
+
+// Most water levels one inundation table may hold
+const std::size_t MAX_INUNDATION_LEVELS = 10000;
+// Most depths held in memory at once (64 MB); larger tables are built and
+// written a block of levels at a time
+const std::size_t MAX_INUNDATION_CELLS = 16 * 1024 * 1024;
+
+// Stage-depth table: flood depth of every place at each of a set of water
+// levels. Holds the columns for every place but only one block of levels.
+struct InundationTable
+{
+    std::vector<float> levels;
+    // Place IDs in column order
+    std::vector<std::size_t> placeIds;
+    // Elevation of each column's place
+    std::vector<float> elevations;
+    // Row-major levels.size() x placeIds.size() matrix of depths
+    std::vector<float> depths;
+    // Number of flooded places at each level
+    std::vector<std::size_t> floodedCounts;
+
+    float depth(std::size_t level, std::size_t column) const
+    {
+        return depths[level * placeIds.size() + column];
+    }
+};
+
+// row[i] = max(level - elevation[i], 0). Runs of DEPTH_RUN have a fixed trip
+// count and restrict-qualified pointers, so GCC vectorizes them at -O2; only
+// the remainder is scalar.
+void fillDepthRow(float *__restrict row, const float *__restrict elevation, float level, std::size_t count)
+{
+    const std::size_t DEPTH_RUN = 64;
+    std::size_t i = 0;
+    for (; i + DEPTH_RUN <= count; i += DEPTH_RUN)
+    {
+        for (std::size_t j = 0; j < DEPTH_RUN; ++j)
+        {
+            row[i + j] = std::max(level - elevation[i + j], 0.0f);
+        }
+    }
+    for (; i < count; ++i)
+    {
+        row[i] = std::max(level - elevation[i], 0.0f);
+    }
+}
+
+// Binary snapshot layout: a header, a fixed-width record per place, the name
+// index's slot table, the offset of each place's rescue history (plus one for
+// the end), a string pool holding the names, then the histories in record
+// order. All fields are host byte order. Older versions lack sections:
+// version 3 has no slot table or history offsets, version 2 no histories
+// either, and version 1 no walSequence.
+const char SNAPSHOT_MAGIC[4] = {'F', 'R', 'M', 'S'};
+const std::uint32_t SNAPSHOT_VERSION = 4;
+const std::size_t SNAPSHOT_V1_HEADER_SIZE = 24;
+const std::size_t SNAPSHOT_V2_HEADER_SIZE = 32;
+const std::size_t SNAPSHOT_V3_HEADER_SIZE = 40;
+// Hashed into the header so a snapshot written by a build whose string hash
+// differs falls back to rebuilding the name index
+const std::string_view SNAPSHOT_HASH_PROBE = "flood risk map";
+
+struct SnapshotHeader
+{
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t placeCount;
+    std::uint64_t stringPoolSize;
+    // Last write-ahead log record already reflected in the snapshot
+    std::uint64_t walSequence;
+    // Bytes of serialized rescue history after the string pool
+    std::uint64_t historySize;
+    // Slots in the stored name index
+    std::uint64_t nameSlotCount;
+    // std::hash of SNAPSHOT_HASH_PROBE in the writing build
+    std::uint64_t nameHashCheck;
+};
+
+struct PlaceRecord
+{
+    double latitude;
+    double longitude;
+    std::uint64_t nameOffset;
+    std::uint32_t nameLength;
+    float elevation;
+    float floodDepth;
+    std::int32_t rescued;
+    std::int32_t maleRescued;
+    std::int32_t femaleRescued;
+    std::int32_t injured;
+    std::int32_t deaths;
+};
+
+static_assert(sizeof(SnapshotHeader) == 56, "snapshot header must have a fixed size");
+static_assert(sizeof(PlaceRecord) == 56, "snapshot records must have a fixed width");
+
+// Read-only memory mapping of a whole file
+class MappedFile
+{
+private:
+    void *data = MAP_FAILED;
+    std::size_t length = 0;
+
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    ~MappedFile()
+    {
+        if (data != MAP_FAILED)
+        {
+            munmap(data, length);
+        }
+    }
+
+    // Map a file; false if it cannot be opened. An empty file maps to no bytes.
+    bool open(const std::string &filename)
+    {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0)
+        {
+            ::close(fd);
+            return false;
+        }
+        length = info.st_size;
+        if (length > 0)
+        {
+            data = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        ::close(fd);
+        return length == 0 || data != MAP_FAILED;
+    }
+
+    const char *begin() const
+    {
+        return data == MAP_FAILED ? nullptr : static_cast<const char *>(data);
+    }
+
+    std::size_t size() const
+    {
+        return length;
+    }
+};
+
+// Read-only memory-mapped view of a snapshot file. Opening validates the
+// header and section sizes only; records, names, the name index and the
+// histories are read in place from the mapping, which must stay open while
+// places use its names or undecoded histories.
+class PlaceSnapshot
+{
+private:
+    MappedFile file;
+    const SnapshotHeader *header = nullptr;
+    const PlaceRecord *records = nullptr;
+    const char *nameSlots = nullptr;
+    const char *historyOffsets = nullptr;
+    const char *stringPool = nullptr;
+    const char *histories = nullptr;
+    std::size_t historyBytes = 0;
+
+public:
+    // Map a snapshot file; false if it is missing or malformed
+    bool open(const std::string &filename)
+    {
+        if (!file.open(filename) || file.size() < SNAPSHOT_V1_HEADER_SIZE)
+        {
+            return false;
+        }
+
+        header = reinterpret_cast<const SnapshotHeader *>(file.begin());
+        if (std::memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0
+            || header->version < 1 || header->version > SNAPSHOT_VERSION)
+        {
+            return false;
+        }
+        const std::uint32_t version = header->version;
+        const std::size_t headerSize = version == 1 ? SNAPSHOT_V1_HEADER_SIZE
+                                     : version == 2 ? SNAPSHOT_V2_HEADER_SIZE
+                                     : version == 3 ? SNAPSHOT_V3_HEADER_SIZE : sizeof(SnapshotHeader);
+        if (file.size() < headerSize)
+        {
+            return false;
+        }
+
+        // Carve the sections off in file order, checking each fits
+        const char *cursor = file.begin() + headerSize;
+        std::size_t remaining = file.size() - headerSize;
+        auto section = [&](std::uint64_t count, std::size_t width, const char *&start)
+        {
+            if (count > remaining / width)
+            {
+                return false;
+            }
+            start = cursor;
+            cursor += count * width;
+            remaining -= count * width;
+            return true;
+        };
+        const char *recordBytes;
+        historyBytes = version < 3 ? 0 : header->historySize;
+        if (!section(header->placeCount, sizeof(PlaceRecord), recordBytes)
+            || (version >= 4 && !section(header->nameSlotCount, 2 * sizeof(std::uint64_t), nameSlots))
+            || (version >= 4 && !section(header->placeCount + 1, sizeof(std::uint64_t), historyOffsets))
+            || !section(header->stringPoolSize, 1, stringPool) || !section(historyBytes, 1, histories) || remaining != 0)
+        {
+            return false;
+        }
+        records = reinterpret_cast<const PlaceRecord *>(recordBytes);
+        return true;
+    }
+
+    std::uint32_t version() const
+    {
+        return header->version;
+    }
+
+    std::size_t placeCount() const
+    {
+        return header->placeCount;
+    }
+
+    std::uint64_t walSequence() const
+    {
+        return header->version == 1 ? 0 : header->walSequence;
+    }
+
+    const PlaceRecord &record(std::size_t i) const
+    {
+        return records[i];
+    }
+
+    // Name of place i; empty if its offsets fall outside the string pool
+    std::string_view name(std::size_t i) const
+    {
+        const PlaceRecord &r = records[i];
+        if (r.nameOffset > header->stringPoolSize || r.nameLength > header->stringPoolSize - r.nameOffset)
+        {
+            return {};
+        }
+        return std::string_view(stringPool + r.nameOffset, r.nameLength);
+    }
+
+    // Stored name index slots, or nullptr if there are none or they were
+    // hashed by a different string hash than this build's
+    const char *nameIndexSlots() const
+    {
+        if (header->version < 4 || header->nameHashCheck != std::hash<std::string_view>{}(SNAPSHOT_HASH_PROBE))
+        {
+            return nullptr;
+        }
+        return nameSlots;
+    }
+
+    std::size_t nameIndexSlotCount() const
+    {
+        return header->version < 4 ? 0 : header->nameSlotCount;
+    }
+
+    // Whether each place's history can be found without decoding the others
+    bool historiesIndexed() const
+    {
+        return header->version >= 4;
+    }
+
+    // Serialized history of place i (version 4); empty if its offsets are bad
+    std::string_view history(std::size_t i) const
+    {
+        std::uint64_t bounds[2];
+        std::memcpy(bounds, historyOffsets + i * sizeof(std::uint64_t), sizeof(bounds));
+        if (bounds[0] > bounds[1] || bounds[1] > historyBytes)
+        {
+            return {};
+        }
+        return std::string_view(histories + bounds[0], bounds[1] - bounds[0]);
+    }
+
+    // All serialized histories back to back, one per record; empty before version 3
+    const char *historyBegin() const
+    {
+        return histories;
+    }
+
+    const char *historyEnd() const
+    {
+        return histories + historyBytes;
+    }
+};
+
+// Skip spaces, tabs and carriage returns
+void skipBlanks(const char *&p, const char *end)
+{
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+    {
+        ++p;
+    }
+}
+
+// Parse a place name: a bare word, or a double-quoted string in which ""
+// stands for one quote. Advances p past the name.
+bool parseName(const char *&p, const char *end, std::string &name)
+{
+    skipBlanks(p, end);
+    name.clear();
+    if (p < end && *p == '"')
+    {
+        for (++p; p < end; ++p)
+        {
+            if (*p == '"')
+            {
+                if (p + 1 < end && p[1] == '"')
+                {
+                    name += '"';
+                    ++p;
+                    continue;
+                }
+                ++p;
+                return true;
+            }
+            name += *p;
+        }
+        return false;
+    }
+
+    const char *start = p;
+    while (p < end && *p != ' ' && *p != '\t' && *p != '\r')
+    {
+        ++p;
+    }
+    name.assign(start, p);
+    return !name.empty();
+}
+
+// Parse one number with std::from_chars. Advances p past it.
+template <typename T>
+bool parseNumber(const char *&p, const char *end, T &value)
+{
+    skipBlanks(p, end);
+    auto [next, error] = std::from_chars(p, end, value);
+    if (error != std::errc())
+    {
+        return false;
+    }
+    p = next;
+    return true;
+}
+
+// Write a name so parseName reads it back, quoting it only when needed
+std::string quoteName(std::string_view name)
+{
+    if (!name.empty() && name.find_first_of(" \t\r\"") == std::string_view::npos)
+    {
+        return std::string(name);
+    }
+    std::string quoted = "\"";
+    for (char c : name)
+    {
+        quoted += c;
+        if (c == '"')
+        {
+            quoted += '"';
+        }
+    }
+    return quoted + "\"";
+}
+
+// Write a name as a CSV field, doubling any embedded quotes
+std::string csvField(std::string_view name)
+{
+    std::string field = "\"";
+    for (char c : name)
+    {
+        field += c;
+        if (c == '"')
+        {
+            field += '"';
+        }
+    }
+    return field + "\"";
+}
+
+// Parse a text file on worker threads. The mapped file is split into
+// line-aligned chunks; parseLine(begin, end, result) fills one result per
+// non-blank line that is not a # comment and returns false for a malformed
+// line. Results are returned per chunk, in file order.
+template <typename Result, typename ParseLine>
+std::vector<std::vector<Result>> parseLinesInParallel(const MappedFile &file, const ParseLine &parseLine, std::size_t &malformed)
+{
+    const char *begin = file.begin(), *end = begin + file.size();
+    unsigned chunkCount = std::max(1u, std::thread::hardware_concurrency());
+    chunkCount = static_cast<unsigned>(std::min<std::size_t>(chunkCount, file.size() / 65536 + 1));
+
+    std::vector<const char *> bounds{begin};
+    for (unsigned c = 1; c < chunkCount; ++c)
+    {
+        const char *split = std::max(bounds.back(), begin + file.size() * c / chunkCount);
+        split = static_cast<const char *>(std::memchr(split, '\n', end - split));
+        bounds.push_back(split == nullptr ? end : split + 1);
+    }
+    bounds.push_back(end);
+
+    std::vector<std::vector<Result>> results(chunkCount);
+    std::vector<std::size_t> malformedCounts(chunkCount, 0);
+    std::vector<std::thread> workers;
+    for (unsigned c = 0; c < chunkCount; ++c)
+    {
+        workers.emplace_back([&, c]()
+        {
+            const char *line = bounds[c], *chunkEnd = bounds[c + 1];
+            Result result;
+            while (line < chunkEnd)
+            {
+                const char *lineEnd = static_cast<const char *>(std::memchr(line, '\n', chunkEnd - line));
+                if (lineEnd == nullptr)
+                {
+                    lineEnd = chunkEnd;
+                }
+                const char *p = line;
+                skipBlanks(p, lineEnd);
+                if (p < lineEnd && *p != '#')
+                {
+                    if (parseLine(p, lineEnd, result))
+                    {
+                        results[c].push_back(std::move(result));
+                    }
+                    else
+                    {
+                        ++malformedCounts[c];
+                    }
+                }
+                line = lineEnd + 1;
+            }
+        });
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    malformed = 0;
+    for (std::size_t count : malformedCounts)
+    {
+        malformed += count;
+    }
+    return results;
+}
+
+// Kinds of mutation recorded in the write-ahead log
+enum class WalRecordType : std::uint8_t
+{
+    Rescue = 1,
+    Elevation = 2,
+    AddPlace = 3,
+    RemovePlace = 4,
+    ResetStatistics = 5
+};
+
+// One logged mutation. Places are named rather than identified by ID, since
+// IDs are reassigned whenever a snapshot is loaded.
+struct WalRecord
+{
+    std::uint64_t sequence = 0;
+    WalRecordType type = WalRecordType::Rescue;
+    std::string name;
+    RescueCounts counts;
+    float elevation = 0;
+    double latitude = 0;
+    double longitude = 0;
+    // Minute a rescue was recorded at, for the place's history; 0 when the
+    // record comes from a log written before the minute was kept
+    std::int64_t minute = 0;
+};
+
+// Append-only log of map mutations made since the last snapshot. Each frame
+// is a payload length, an FNV-1a checksum and the payload, so a frame torn by
+// a crash is detected on replay and cut off. The payload holds the fixed
+// fields, the name and the minute; older logs end each payload at the name.
+// Appends only encode into a buffer; a flusher thread writes whatever has
+// gathered and calls fdatasync once per batch (group commit), so an update
+// costs a copy and a lock rather than a disk flush. A crash loses at most the
+// last commit interval. If a write or flush fails, the file is cut back to the
+// end of the last durable batch and later batches are dropped until a
+// checkpoint truncates the log, so no record is ever appended after a torn
+// frame.
+class WriteAheadLog
+{
+private:
+    static constexpr std::size_t FRAME_HEADER_SIZE = 8;
+    static constexpr std::size_t PAYLOAD_FIXED_SIZE = 8 + 1 + 4 + 8 + 8 + 16 + 2;
+    static constexpr std::size_t PAYLOAD_MINUTE_SIZE = 8;
+    static constexpr std::size_t GROUP_COMMIT_BYTES = 64 * 1024;
+    static constexpr auto GROUP_COMMIT_INTERVAL = std::chrono::milliseconds(5);
+
+    int fd = -1;
+    std::mutex mutex;
+    std::condition_variable wakeFlusher;
+    std::condition_variable flushed;
+    std::string pending;
+    std::uint64_t appendedSequence = 0;
+    std::uint64_t durableSequence = 0;
+    // File size covered by durable batches; only the flusher and truncate() move it
+    off_t durableOffset = 0;
+    std::size_t recordCount = 0;
+    bool flushing = false;
+    bool stopping = false;
+    bool failed = false;
+    std::thread flusher;
+
+    static std::uint32_t checksum(const char *data, std::size_t size)
+    {
+        std::uint32_t hash = 2166136261u;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            hash = (hash ^ static_cast<unsigned char>(data[i])) * 16777619u;
+        }
+        return hash;
+    }
+
+    template <typename T>
+    static void put(std::string &out, const T &value)
+    {
+        out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+    template <typename T>
+    static T get(const char *&p)
+    {
+        T value;
+        std::memcpy(&value, p, sizeof(value));
+        p += sizeof(value);
+        return value;
+    }
+
+    static void encode(const WalRecord &record, std::string &out)
+    {
+        std::uint16_t nameLength = static_cast<std::uint16_t>(std::min<std::size_t>(record.name.size(), UINT16_MAX));
+        std::size_t frameStart = out.size();
+        const std::uint32_t length = PAYLOAD_FIXED_SIZE + nameLength + PAYLOAD_MINUTE_SIZE;
+        put(out, length);
+        put(out, std::uint32_t(0));
+        put(out, record.sequence);
+        put(out, static_cast<std::uint8_t>(record.type));
+        put(out, record.elevation);
+        put(out, record.latitude);
+        put(out, record.longitude);
+        put(out, static_cast<std::int32_t>(record.counts.males));
+        put(out, static_cast<std::int32_t>(record.counts.females));
+        put(out, static_cast<std::int32_t>(record.counts.injured));
+        put(out, static_cast<std::int32_t>(record.counts.deaths));
+        put(out, nameLength);
+        out.append(record.name, 0, nameLength);
+        put(out, record.minute);
+
+        std::uint32_t sum = checksum(out.data() + frameStart + FRAME_HEADER_SIZE, length);
+        std::memcpy(&out[frameStart + 4], &sum, sizeof(sum));
+    }
+
+    // Decode a checksummed payload of the given length; false if its name
+    // runs past the payload
+    static bool decode(const char *p, std::uint32_t length, WalRecord &record)
+    {
+        record.sequence = get<std::uint64_t>(p);
+        record.type = static_cast<WalRecordType>(get<std::uint8_t>(p));
+        record.elevation = get<float>(p);
+        record.latitude = get<double>(p);
+        record.longitude = get<double>(p);
+        record.counts.males = get<std::int32_t>(p);
+        record.counts.females = get<std::int32_t>(p);
+        record.counts.injured = get<std::int32_t>(p);
+        record.counts.deaths = get<std::int32_t>(p);
+        record.counts.rescued = record.counts.males + record.counts.females;
+        std::uint16_t nameLength = get<std::uint16_t>(p);
+        if (nameLength > length - PAYLOAD_FIXED_SIZE)
+        {
+            return false;
+        }
+        record.name.assign(p, nameLength);
+        p += nameLength;
+        record.minute = length - PAYLOAD_FIXED_SIZE - nameLength >= PAYLOAD_MINUTE_SIZE ? get<std::int64_t>(p) : 0;
+        return true;
+    }
+
+    static bool writeAll(int fd, const std::string &data)
+    {
+        std::size_t written = 0;
+        while (written < data.size())
+        {
+            ssize_t n = ::write(fd, data.data() + written, data.size() - written);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+            written += n;
+        }
+        return true;
+    }
+
+    static bool syncData(int fd)
+    {
+        int result;
+        do
+        {
+            result = fdatasync(fd);
+        } while (result != 0 && errno == EINTR);
+        return result == 0;
+    }
+
+    void flushLoop()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true)
+        {
+            wakeFlusher.wait_for(lock, GROUP_COMMIT_INTERVAL,
+                                 [this]() { return stopping || pending.size() >= GROUP_COMMIT_BYTES; });
+            if (failed)
+            {
+                // The log is already incomplete; appending would only bury the gap
+                pending.clear();
+            }
+            if (!pending.empty())
+            {
+                std::string batch;
+                batch.swap(pending);
+                std::uint64_t batchSequence = appendedSequence;
+                flushing = true;
+                lock.unlock();
+                bool ok = writeAll(fd, batch) && syncData(fd);
+                if (!ok && ftruncate(fd, durableOffset) == 0)
+                {
+                    syncData(fd);
+                }
+                lock.lock();
+                flushing = false;
+                if (ok)
+                {
+                    durableSequence = batchSequence;
+                    durableOffset += batch.size();
+                }
+                else
+                {
+                    failed = true;
+                    std::cerr << "Unable to write the write-ahead log; further updates are not durable until the next checkpoint.\n";
+                }
+                flushed.notify_all();
+            }
+            if (stopping && pending.empty())
+            {
+                return;
+            }
+        }
+    }
+
+public:
+    ~WriteAheadLog()
+    {
+        close();
+    }
+
+    // Open a log for appending; new records are numbered after lastSequence
+    bool open(const std::string &filename, std::uint64_t lastSequence)
+    {
+        close();
+        fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (fd < 0)
+        {
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0)
+        {
+            ::close(fd);
+            fd = -1;
+            return false;
+        }
+        durableOffset = info.st_size;
+        appendedSequence = durableSequence = lastSequence;
+        stopping = failed = false;
+        flusher = std::thread(&WriteAheadLog::flushLoop, this);
+        return true;
+    }
+
+    bool isOpen() const
+    {
+        return fd >= 0;
+    }
+
+    // Queue a record for the next group commit; returns its sequence number
+    std::uint64_t append(WalRecord record)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        record.sequence = ++appendedSequence;
+        encode(record, pending);
+        ++recordCount;
+        if (pending.size() >= GROUP_COMMIT_BYTES)
+        {
+            wakeFlusher.notify_one();
+        }
+        return record.sequence;
+    }
+
+    // Wait until every record appended so far is on disk
+    void sync()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        wakeFlusher.notify_one();
+        flushed.wait(lock, [this]() { return failed || (durableSequence == appendedSequence && !flushing); });
+    }
+
+    // Sequence number of the newest record
+    std::uint64_t lastSequence()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return appendedSequence;
+    }
+
+    // Records appended since the log was opened or last truncated
+    std::size_t size()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return recordCount;
+    }
+
+    // Discard every record; called once a snapshot holds all of them. A log
+    // that failed earlier is usable again once it is empty.
+    void truncate()
+    {
+        sync();
+        std::unique_lock<std::mutex> lock(mutex);
+        flushed.wait(lock, [this]() { return !flushing; });
+        if (ftruncate(fd, 0) != 0 || !syncData(fd))
+        {
+            std::cerr << "Unable to truncate the write-ahead log.\n";
+            recordCount = 0;
+            return;
+        }
+        durableOffset = 0;
+        durableSequence = appendedSequence;
+        pending.clear();
+        failed = false;
+        recordCount = 0;
+    }
+
+    // Flush outstanding records and stop the flusher
+    void close()
+    {
+        if (fd < 0)
+        {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeFlusher.notify_one();
+        flusher.join();
+        ::close(fd);
+        fd = -1;
+    }
+
+    // Pass every intact record with a sequence above afterSequence to
+    // apply(record), in order. A torn or corrupt tail is cut off the file.
+    // Returns the highest sequence seen, or afterSequence if none.
+    template <typename Apply>
+    static std::uint64_t replay(const std::string &filename, std::uint64_t afterSequence, const Apply &apply, std::size_t &replayed)
+    {
+        replayed = 0;
+        std::uint64_t lastSequence = afterSequence;
+        MappedFile file;
+        if (!file.open(filename))
+        {
+            return lastSequence;
+        }
+
+        const char *begin = file.begin();
+        std::size_t offset = 0;
+        while (file.size() - offset >= FRAME_HEADER_SIZE)
+        {
+            const char *frame = begin + offset;
+            std::uint32_t length = get<std::uint32_t>(frame);
+            std::uint32_t sum = get<std::uint32_t>(frame);
+            if (length < PAYLOAD_FIXED_SIZE || length > file.size() - offset - FRAME_HEADER_SIZE
+                || checksum(frame, length) != sum)
+            {
+                break;
+            }
+            WalRecord record;
+            if (!decode(frame, length, record))
+            {
+                break;
+            }
+            if (record.sequence > afterSequence)
+            {
+                apply(record);
+                ++replayed;
+            }
+            lastSequence = std::max(lastSequence, record.sequence);
+            offset += FRAME_HEADER_SIZE + length;
+        }
+
+        if (offset < file.size())
+        {
+            std::cout << "Discarding " << file.size() - offset << " bytes of incomplete log records.\n";
+            if (::truncate(filename.c_str(), offset) != 0)
+            {
+                std::cerr << "Unable to truncate the write-ahead log.\n";
+            }
+        }
+        return lastSequence;
+    }
+};
+
+// Durable state kept in the working directory: the last compacted snapshot and
+// the log of updates made since
+const std::string DURABLE_SNAPSHOT_FILE = "flood_map.snapshot";
+const std::string WAL_FILE = "flood_map.wal";
+// Fold the log into the snapshot once it holds this many records
+const std::size_t WAL_COMPACTION_RECORDS = 100000;
+
+// Class to represent the flood risk map
+class FloodRiskMap
+{
+private:
+    // Snapshot the places were last loaded from; their names and undecoded
+    // histories point into it
+    std::unique_ptr<PlaceSnapshot> mappedSnapshot;
+    // List of places in display order
+    std::vector<Place> places;
+    // Position in places of each place ID (NO_PLACE once removed)
+    std::vector<std::size_t> positionOf;
+    // IDs released by removed places, reused before new IDs are issued
+    std::vector<std::size_t> freeIds;
+    // Name to place ID
+    PlaceNameIndex nameIndex;
+    // Spatial index over place positions, keyed by place ID. Bulk loads only
+    // mark this and the elevation index stale; read them through spatial()
+    // and byElevation(), which build them on first use.
+    mutable PlaceKdTree spatialIndex;
+    // Place IDs sorted by elevation
+    mutable ElevationIndex elevationIndex;
+    // True once the spatial and elevation indexes cover every place
+    mutable bool orderIndexesBuilt = false;
+    // IDs of places given a nonzero flood depth by the last calculation
+    std::vector<std::size_t> floodedPlaces;
+    // Rescue reports from concurrent writers, not yet applied to places
+    RescueTracker rescueTracker;
+    // Totals over all places
+    MapAggregates aggregates;
+    // Log of updates since the durable snapshot
+    WriteAheadLog wal;
+    // Set by changes the log does not record (flood depths, sort order),
+    // which only a checkpoint makes durable
+    bool unloggedChanges = false;
+
+    void initializePlaces()
+    {
+        // Initialize places with sample data
+        places = {
+            {"Colaba", 3.0, 18.9067, 72.8147}, {"Marine Drive", 2.5, 18.9430, 72.8238}, {"Dadar", 6.0, 19.0178, 72.8478},
+            {"Bandra", 7.0, 19.0596, 72.8295}, {"Andheri", 8.0, 19.1136, 72.8697}, {"Borivali", 10.0, 19.2307, 72.8567},
+            {"Thane", 15.0, 19.2183, 72.9781}, {"Navi Mumbai", 5.0, 19.0330, 73.0297}, {"Panvel", 4.0, 18.9894, 73.1175},
+            {"Vasai", 6.5, 19.3919, 72.8397}, {"Virar", 12.0, 19.4559, 72.8114}, {"Kalyan", 7.5, 19.2403, 73.1305}};
+        rebuildIndexes();
+    }
+
+    // Assign fresh IDs to the current places and rebuild every index
+    void rebuildIndexes()
+    {
+        renumberPlaces();
+        rebuildNameIndex();
+        recountPlaces();
+    }
+
+    // Give the places IDs 0..n-1 in storage order
+    void renumberPlaces()
+    {
+        positionOf.resize(places.size());
+        freeIds.clear();
+        for (std::size_t i = 0; i < places.size(); ++i)
+        {
+            places[i].id = i;
+            positionOf[i] = i;
+        }
+    }
+
+    void rebuildNameIndex()
+    {
+        nameIndex.clear();
+        nameIndex.reserve(places.size());
+        for (const auto &place : places)
+        {
+            nameIndex.insert(place.name, place.id, placeName());
+        }
+    }
+
+    // Mark the ordered indexes stale and recompute the flooded list and totals
+    void recountPlaces()
+    {
+        orderIndexesBuilt = false;
+        floodedPlaces.clear();
+        aggregates = MapAggregates();
+        for (const auto &place : places)
+        {
+            if (place.floodDepth != 0)
+            {
+                floodedPlaces.push_back(place.id);
+            }
+            countPlace(place, 1);
+        }
+    }
+
+    // Add (sign 1) or remove (sign -1) rescue counts from the totals
+    void countRescues(const RescueCounts &counts, int sign)
+    {
+        aggregates.rescued += sign * counts.rescued;
+        aggregates.males += sign * counts.males;
+        aggregates.females += sign * counts.females;
+        aggregates.injured += sign * counts.injured;
+        aggregates.deaths += sign * counts.deaths;
+    }
+
+    // Add (sign 1) or remove (sign -1) a place's elevation from the risk totals
+    void countElevation(float elevation, int sign)
+    {
+        if (elevation < FLOOD_THRESHOLD)
+        {
+            aggregates.riskZones += sign;
+            aggregates.riskZoneElevation += sign * static_cast<double>(elevation);
+        }
+    }
+
+    // Add (sign 1) or remove (sign -1) a whole place from the totals
+    void countPlace(const Place &place, int sign)
+    {
+        countRescues({place.rescued, place.maleRescued, place.femaleRescued, place.injured, place.deaths}, sign);
+        countElevation(place.elevation, sign);
+    }
+
+    // Build the spatial and elevation indexes if a bulk load deferred them
+    void buildOrderIndexes() const
+    {
+        if (!orderIndexesBuilt)
+        {
+            spatialIndex.build(places);
+            elevationIndex.build(places);
+            orderIndexesBuilt = true;
+        }
+    }
+
+    const PlaceKdTree &spatial() const
+    {
+        buildOrderIndexes();
+        return spatialIndex;
+    }
+
+    const ElevationIndex &byElevation() const
+    {
+        buildOrderIndexes();
+        return elevationIndex;
+    }
+
+    // Issue an ID for the place stored at position, reusing a released one if any
+    std::size_t takeId(std::size_t position)
+    {
+        if (freeIds.empty())
+        {
+            positionOf.push_back(position);
+            return positionOf.size() - 1;
+        }
+        std::size_t id = freeIds.back();
+        freeIds.pop_back();
+        positionOf[id] = position;
+        return id;
+    }
+
+    // Mark an ID unused so a later place can take it
+    void releaseId(std::size_t id)
+    {
+        positionOf[id] = NO_PLACE;
+        freeIds.push_back(id);
+    }
+
+    // Refresh ID positions for places[from..] after they moved
+    void updatePositions(std::size_t from = 0)
+    {
+        for (std::size_t i = from; i < places.size(); ++i)
+        {
+            positionOf[places[i].id] = i;
+        }
+    }
+
+    // Name lookup used by the hash index
+    std::function<std::string_view(std::size_t)> placeName() const
+    {
+        return [this](std::size_t id) { return places[positionOf[id]].name; };
+    }
+
+    // Place with a given ID
+    Place &placeById(std::size_t id)
+    {
+        return places[positionOf[id]];
+    }
+
+    const Place &placeById(std::size_t id) const
+    {
+        return places[positionOf[id]];
+    }
+
+    // Place with a given name, or nullptr
+    Place *findPlace(const std::string &name)
+    {
+        std::size_t id = nameIndex.find(name, placeName());
+        return id == NO_PLACE ? nullptr : &placeById(id);
+    }
+
+    // The mutations below change the map without printing or logging; the
+    // menu operations and log replay share them
+
+    // A nonzero minute also adds the rescue to the place's history
+    Place *applyRescue(const std::string &name, const RescueCounts &counts, std::int64_t minute)
+    {
+        Place *place = findPlace(name);
+        if (place == nullptr)
+        {
+            return nullptr;
+        }
+        place->maleRescued += counts.males;
+        place->femaleRescued += counts.females;
+        place->rescued += counts.rescued;
+        place->injured += counts.injured;
+        place->deaths += counts.deaths;
+        if (minute != 0)
+        {
+            place->rescueHistory.append(minute, counts.rescued);
+        }
+        countRescues(counts, 1);
+        return place;
+    }
+
+    bool applyElevation(const std::string &name, float newElevation)
+    {
+        Place *place = findPlace(name);
+        if (place == nullptr)
+        {
+            return false;
+        }
+        if (orderIndexesBuilt)
+        {
+            elevationIndex.update(place->id, place->elevation, newElevation);
+        }
+        countElevation(place->elevation, -1);
+        countElevation(newElevation, 1);
+        place->elevation = newElevation;
+        return true;
+    }
+
+    bool applyAddPlace(const std::string &name, float elevation, double latitude, double longitude)
+    {
+        places.emplace_back(name, elevation, latitude, longitude);
+        std::size_t id = takeId(places.size() - 1);
+        places.back().id = id;
+        if (!nameIndex.insert(name, id, placeName()))
+        {
+            places.pop_back();
+            releaseId(id);
+            return false;
+        }
+
+        if (orderIndexesBuilt)
+        {
+            auto [x, y] = mapPosition(places.back());
+            spatialIndex.insert(id, x, y);
+            elevationIndex.insert(id, elevation);
+        }
+        countPlace(places.back(), 1);
+        return true;
+    }
+
+    bool applyRemovePlace(const std::string &name)
+    {
+        Place *place = findPlace(name);
+        if (place == nullptr)
+        {
+            return false;
+        }
+        std::size_t id = place->id, position = positionOf[id];
+        if (orderIndexesBuilt)
+        {
+            auto [x, y] = mapPosition(*place);
+            spatialIndex.erase(id, x, y);
+            elevationIndex.erase(id, place->elevation);
+        }
+        nameIndex.erase(name, placeName());
+        countPlace(*place, -1);
+        if (place->floodDepth != 0)
+        {
+            auto flooded = std::find(floodedPlaces.begin(), floodedPlaces.end(), id);
+            if (flooded != floodedPlaces.end())
+            {
+                *flooded = floodedPlaces.back();
+                floodedPlaces.pop_back();
+            }
+        }
+
+        // Storage order is the listing order the user last sorted into, so
+        // close the gap rather than moving the last place into it
+        places.erase(places.begin() + position);
+        releaseId(id);
+        updatePositions(position);
+        return true;
+    }
+
+    bool applyResetStatistics(const std::string &name)
+    {
+        Place *place = findPlace(name);
+        if (place == nullptr)
+        {
+            return false;
+        }
+        countPlace(*place, -1);
+        place->rescued = 0;
+        place->maleRescued = 0;
+        place->femaleRescued = 0;
+        place->injured = 0;
+        place->deaths = 0;
+        place->rescueHistory.clear();
+        countPlace(*place, 1);
+        return true;
+    }
+
+    // Apply a record read back from the write-ahead log
+    void applyLogged(const WalRecord &record)
+    {
+        switch (record.type)
+        {
+        case WalRecordType::Rescue:
+            applyRescue(record.name, record.counts, record.minute);
+            break;
+        case WalRecordType::Elevation:
+            applyElevation(record.name, record.elevation);
+            break;
+        case WalRecordType::AddPlace:
+            applyAddPlace(record.name, record.elevation, record.latitude, record.longitude);
+            break;
+        case WalRecordType::RemovePlace:
+            applyRemovePlace(record.name);
+            break;
+        case WalRecordType::ResetStatistics:
+            applyResetStatistics(record.name);
+            break;
+        }
+    }
+
+    // Log a mutation that has just been applied
+    void logMutation(WalRecord record)
+    {
+        if (!wal.isOpen())
+        {
+            return;
+        }
+        wal.append(std::move(record));
+    }
+
+    // Load the durable snapshot, replay the log on top, and reopen the log
+    void recover()
+    {
+        std::uint64_t snapshotSequence = 0;
+        readSnapshot(DURABLE_SNAPSHOT_FILE, snapshotSequence);
+
+        std::size_t replayed = 0;
+        std::uint64_t lastSequence = WriteAheadLog::replay(WAL_FILE, snapshotSequence, [this](const WalRecord &record)
+        {
+            applyLogged(record);
+        }, replayed);
+        if (replayed > 0)
+        {
+            std::cout << "Recovered " << replayed << " logged updates.\n";
+        }
+        if (!wal.open(WAL_FILE, lastSequence))
+        {
+            std::cerr << "Unable to open " << WAL_FILE << "; updates will not survive a crash.\n";
+        }
+    }
+
+    // Write the whole map to the durable snapshot and empty the log; nothing
+    // is written when the snapshot and log already hold every change
+    void checkpoint()
+    {
+        if (!wal.isOpen())
+        {
+            return;
+        }
+        publishRescueUpdates();
+        if (wal.size() == 0 && !unloggedChanges)
+        {
+            return;
+        }
+        if (writeSnapshot(DURABLE_SNAPSHOT_FILE, wal.lastSequence()))
+        {
+            wal.truncate();
+            unloggedChanges = false;
+        }
+    }
+
+    // Fold a long log into the snapshot. Called between menu operations, so
+    // no read or update waits on a full snapshot write.
+    void compactLogIfLong()
+    {
+        if (wal.isOpen() && wal.size() >= WAL_COMPACTION_RECORDS)
+        {
+            checkpoint();
+        }
+    }
+
+    // Write a snapshot file atomically and durably
+    bool writeSnapshot(const std::string &filename, std::uint64_t walSequence)
+    {
+        std::vector<PlaceRecord> records(places.size());
+        std::string stringPool;
+        for (std::size_t i = 0; i < places.size(); ++i)
+        {
+            const Place &place = places[i];
+            PlaceRecord &record = records[i];
+            std::memset(&record, 0, sizeof(record));
+            record.latitude = place.latitude;
+            record.longitude = place.longitude;
+            record.nameOffset = stringPool.size();
+            record.nameLength = static_cast<std::uint32_t>(place.name.size());
+            record.elevation = place.elevation;
+            record.floodDepth = place.floodDepth;
+            record.rescued = place.rescued;
+            record.maleRescued = place.maleRescued;
+            record.femaleRescued = place.femaleRescued;
+            record.injured = place.injured;
+            record.deaths = place.deaths;
+            stringPool += place.name;
+        }
+        std::string slots;
+        nameIndex.exportSlots(slots, [this](std::size_t id) { return positionOf[id]; });
+        std::vector<std::uint64_t> historyOffsets;
+        historyOffsets.reserve(places.size() + 1);
+        std::string history;
+        for (const Place &place : places)
+        {
+            historyOffsets.push_back(history.size());
+            place.rescueHistory.serialize(history);
+        }
+        historyOffsets.push_back(history.size());
+
+        SnapshotHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+        header.version = SNAPSHOT_VERSION;
+        header.placeCount = records.size();
+        header.stringPoolSize = stringPool.size();
+        header.walSequence = walSequence;
+        header.historySize = history.size();
+        header.nameSlotCount = nameIndex.slotCount();
+        header.nameHashCheck = std::hash<std::string_view>{}(SNAPSHOT_HASH_PROBE);
+
+        std::string temporary = filename + ".tmp";
+        std::ofstream outFile(temporary, std::ios::binary | std::ios::trunc);
+        if (!outFile.is_open())
+        {
+            std::cerr << "Unable to open file for writing.\n";
+            return false;
+        }
+        outFile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        outFile.write(reinterpret_cast<const char *>(records.data()), records.size() * sizeof(PlaceRecord));
+        outFile.write(slots.data(), slots.size());
+        outFile.write(reinterpret_cast<const char *>(historyOffsets.data()), historyOffsets.size() * sizeof(std::uint64_t));
+        outFile.write(stringPool.data(), stringPool.size());
+        outFile.write(history.data(), history.size());
+        outFile.close();
+
+        // The data must be on disk before the rename makes it visible
+        int fd = ::open(temporary.c_str(), O_RDONLY);
+        bool synced = fd >= 0 && fsync(fd) == 0;
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+        if (!outFile || !synced || std::rename(temporary.c_str(), filename.c_str()) != 0)
+        {
+            std::cerr << "Unable to write snapshot " << filename << ".\n";
+            return false;
+        }
+        std::size_t slash = filename.rfind('/');
+        std::string directory = slash == std::string::npos ? "." : filename.substr(0, slash + 1);
+        fd = ::open(directory.c_str(), O_RDONLY);
+        if (fd >= 0)
+        {
+            fsync(fd);
+            ::close(fd);
+        }
+        return true;
+    }
+
+    // Replace all places with the contents of a snapshot file. The file stays
+    // mapped: names are views into its string pool, the name index is copied
+    // from its slot table without rehashing, and histories are decoded on
+    // first use. Only the fixed-width records are copied, since elevations
+    // and counters change in place. Older snapshots fall back to rebuilding
+    // the name index and decoding every history.
+    bool readSnapshot(const std::string &filename, std::uint64_t &walSequence)
+    {
+        auto snapshot = std::make_unique<PlaceSnapshot>();
+        if (!snapshot->open(filename))
+        {
+            return false;
+        }
+
+        // One pass builds each place, so its memory is touched only once
+        std::vector<Place> loaded;
+        loaded.reserve(snapshot->placeCount());
+        std::vector<std::size_t> positions(snapshot->placeCount());
+        // Version 3 histories lie back to back and can only be read in order
+        const char *history = snapshot->historyBegin();
+        const bool sequentialHistory = !snapshot->historiesIndexed() && history != snapshot->historyEnd();
+        for (std::size_t i = 0; i < snapshot->placeCount(); ++i)
+        {
+            const PlaceRecord &record = snapshot->record(i);
+            Place &place = loaded.emplace_back();
+            place.name = snapshot->name(i);
+            place.elevation = record.elevation;
+            place.latitude = record.latitude;
+            place.longitude = record.longitude;
+            place.floodDepth = record.floodDepth;
+            place.rescued = record.rescued;
+            place.maleRescued = record.maleRescued;
+            place.femaleRescued = record.femaleRescued;
+            place.injured = record.injured;
+            place.deaths = record.deaths;
+            place.id = i;
+            positions[i] = i;
+            if (snapshot->historiesIndexed())
+            {
+                place.rescueHistory.attach(snapshot->history(i));
+            }
+            else if (sequentialHistory && !place.rescueHistory.deserialize(history, snapshot->historyEnd()))
+            {
+                return false;
+            }
+        }
+        if (sequentialHistory && history != snapshot->historyEnd())
+        {
+            return false;
+        }
+
+        places.swap(loaded);
+        positionOf.swap(positions);
+        freeIds.clear();
+        const char *slots = snapshot->nameIndexSlots();
+        if (slots == nullptr || !nameIndex.importSlots(slots, snapshot->nameIndexSlotCount(), places.size()))
+        {
+            rebuildNameIndex();
+        }
+        recountPlaces();
+        walSequence = snapshot->walSequence();
+        // The previous places are gone, so their snapshot can be unmapped
+        loaded.clear();
+        mappedSnapshot = std::move(snapshot);
+        return true;
+    }
+
+public:
+    FloodRiskMap()
+
+    {
+        initializePlaces();
+        recover();
+    }
+
+    ~FloodRiskMap()
+    {
+        wal.close();
+    }
+
+    // Identify flood risk zones based on elevation
+    void identifyFloodRiskZones()
+
+    {
+        std::cout << "\nFlood Risk Zones:\n";
+        std::size_t riskCount = byElevation().countBelow(FLOOD_THRESHOLD);
+        for (std::size_t rank = 0; rank < riskCount; ++rank)
+
+        {
+            const Place &place = placeById(byElevation().orderedIds()[rank]);
+            std::cout << "Risk Zone: " << place.name << " with elevation " << place.elevation << "\n";
+        }
+
+    }
+
+    // Calculate flood depth based on water level
+
+    void calculateFloodDepth(float waterLevel)
+
+    {
+        // Only places flooded last time and places below the new level change
+        for (std::size_t id : floodedPlaces)
+        {
+            if (positionOf[id] != NO_PLACE)
+            {
+                placeById(id).floodDepth = 0;
+            }
+        }
+
+        std::cout << "\nFlood Depth Mapping:\n";
+        std::size_t floodedCount = byElevation().countBelow(waterLevel);
+        const std::vector<std::size_t> &ordered = byElevation().orderedIds();
+        floodedPlaces.assign(ordered.begin(), ordered.begin() + floodedCount);
+        for (std::size_t id : floodedPlaces)
+
+        {
+            Place &place = placeById(id);
+            place.floodDepth = waterLevel - place.elevation;
+            std::cout << "Flood depth at " << place.name << " is " << place.floodDepth << "\n";
+        }
+        unloggedChanges = true;
+    }
+
+    // Save the map to a file
+    void saveMapToFile(const std::string &filename)
+    {
+        publishRescueUpdates();
+        std::ofstream outFile(filename);
+        if (outFile.is_open())
+        {
+            for (const auto &place : places)
+            {
+                outFile << place.name << " " << place.elevation << " " << place.floodDepth << " "
+                        << place.rescued << " " << place.maleRescued << " " << place.femaleRescued << " "
+                        << place.injured << " " << place.deaths << "\n";
+            }
+            outFile.close();
+            std::cout << "\nMap saved to " << filename << "\n";
+        }
+        else
+        {
+            std::cerr << "\nUnable to open file for writing.\n";
+        }
+    }
+
+    // Print the map for visualization
+    void printMap()
+    {
+        publishRescueUpdates();
+        std::cout << "\nPlace Elevation and Flood Depth:\n";
+        for (const auto &place : places)
+        {
+            std::cout << place.name << " - Elevation: " << std::setw(5) << place.elevation
+                      << " Flood Depth: " << std::setw(5) << place.floodDepth
+                      << " Rescued: " << place.rescued
+                      << " Injured: " << place.injured
+                      << " Deaths: " << place.deaths << "\n";
+        }
+    }
+
+    // Analyze flood risk and count risk zones
+    void analyzeFloodRisk()
+    {
+        std::cout << "\nTotal flood risk zones identified: " << aggregates.riskZones << "\n";
+    }
+
+    // Display statistics about flood risk zones
+    void displayFloodRiskStatistics()
+    {
+        std::size_t riskCount = aggregates.riskZones;
+        float averageElevation = (riskCount > 0) ? static_cast<float>(aggregates.riskZoneElevation / riskCount) : 0;
+        std::cout << "\nTotal flood risk zones: " << riskCount << "\n";
+        std::cout << "Average elevation of risk zones: " << averageElevation << "\n";
+
+    }
+
+    // Find the nearest flood risk zone to a given place
+    void findNearestFloodRiskZone(const std::string &placeName)
+    {
+        findNearestFloodRiskZones(placeName, 1);
+    }
+
+    // Find the k nearest flood risk zones to a given place by map distance
+    void findNearestFloodRiskZones(const std::string &placeName, std::size_t k)
+    {
+        Place *place = findPlace(placeName);
+
+        if (place == nullptr)
+        {
+            std::cout << "\nPlace " << placeName << " not found.\n";
+            return;
+        }
+
+        const Place &currentPlace = *place;
+        auto [x, y] = mapPosition(currentPlace);
+        auto nearest = spatial().nearest(x, y, k, [&](std::size_t id)
+                                            { return placeById(id).elevation < FLOOD_THRESHOLD && id != currentPlace.id; });
+
+        if (nearest.empty())
+        {
+            std::cout << "\nNo flood risk zones found.\n";
+        }
+        else if (k == 1)
+        {
+            std::cout << "\nNearest flood risk zone to " << placeName << " is " << placeById(nearest[0].second).name
+                      << " (" << nearest[0].first << " km)\n";
+        }
+        else
+        {
+            std::cout << "\nNearest flood risk zones to " << placeName << ":\n";
+            for (const auto &[distance, id] : nearest)
+            {
+                const Place &zone = placeById(id);
+                std::cout << zone.name << " - " << distance << " km, Elevation: " << zone.elevation << "\n";
+            }
+        }
+    }
+
+    // List places within a radius (km) of a given place
+    void findPlacesWithinRadius(const std::string &placeName, double radius)
+    {
+        Place *place = findPlace(placeName);
+
+        if (place == nullptr)
+        {
+            std::cout << "\nPlace " << placeName << " not found.\n";
+            return;
+        }
+
+        auto [x, y] = mapPosition(*place);
+        auto found = spatial().withinRadius(x, y, radius, [&](std::size_t id) { return id != place->id; });
+        std::cout << "\nPlaces within " << radius << " km of " << placeName << ":\n";
+        for (const auto &[distance, id] : found)
+        {
+            const Place &nearby = placeById(id);
+            std::cout << nearby.name << " - " << distance << " km, Elevation: " << nearby.elevation
+                      << (nearby.elevation < FLOOD_THRESHOLD ? " (Risk Zone)" : "") << "\n";
+        }
+        if (found.empty())
+        {
+            std::cout << "None\n";
+        }
+    }
 
+    // Columns of an inundation table: every place's ID and elevation, the
+    // elevations in one contiguous array for fillDepthRow
+    InundationTable inundationColumns() const
     {
-        std::cout << "\nFlood Risk Zones:\n";
-        for (const auto &place : places)
-
+        InundationTable table;
+        table.placeIds.resize(places.size());
+        table.elevations.resize(places.size());
+        for (std::size_t i = 0; i < places.size(); ++i)
         {
-            if (place.elevation < FLOOD_THRESHOLD)
+            table.placeIds[i] = places[i].id;
+            table.elevations[i] = places[i].elevation;
+        }
+        return table;
+    }
 
+    // Fill the depth rows and flooded counts for table.levels. Levels are
+    // split across threads, each writing its own rows of the matrix.
+    void fillInundationRows(InundationTable &table) const
+    {
+        const std::size_t placeCount = table.placeIds.size();
+        const ElevationIndex &ordered = byElevation();
+        table.depths.resize(table.levels.size() * placeCount);
+        table.floodedCounts.resize(table.levels.size());
+
+        unsigned threadCount = std::max(1u, std::min<unsigned>(std::thread::hardware_concurrency(), table.levels.size()));
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threadCount; ++t)
+        {
+            workers.emplace_back([&, t]()
             {
-                std::cout << "Risk Zone: " << place.name << " with elevation " << place.elevation << "\n";
-            }
-
+                for (std::size_t l = t; l < table.levels.size(); l += threadCount)
+                {
+                    fillDepthRow(table.depths.data() + l * placeCount, table.elevations.data(), table.levels[l], placeCount);
+                    table.floodedCounts[l] = ordered.countBelow(table.levels[l]);
+                }
+            });
+        }
+        for (auto &worker : workers)
+        {
+            worker.join();
         }
-
     }
 
-    // Calculate flood depth based on water level
-
-    void calculateFloodDepth(float waterLevel)
-
+    // Build and summarise an inundation table for evenly spaced water levels.
+    // Levels are computed in blocks of at most MAX_INUNDATION_CELLS depths,
+    // and each block is summarised and written before the next is built.
+    void generateInundationTable(float minLevel, float maxLevel, float step, const std::string &filename)
     {
-        std::cout << "\nFlood Depth Mapping:\n";
-        for (auto &place : places)
+        if (!std::isfinite(minLevel) || !std::isfinite(maxLevel) || !(step > 0) || maxLevel < minLevel)
+        {
+            std::cout << "Invalid water level range.\n";
+            return;
+        }
+        double spanSteps = (static_cast<double>(maxLevel) - minLevel) / step + 1e-3;
+        if (spanSteps >= MAX_INUNDATION_LEVELS)
+        {
+            std::cout << "Too many water levels; at most " << MAX_INUNDATION_LEVELS << " are allowed.\n";
+            return;
+        }
+        const std::size_t levelCount = static_cast<std::size_t>(spanSteps) + 1;
 
+        InundationTable table = inundationColumns();
+        const std::size_t placeCount = table.placeIds.size();
+        const std::size_t blockLevels = std::max<std::size_t>(1, MAX_INUNDATION_CELLS / std::max<std::size_t>(1, placeCount));
+
+        std::ofstream outFile;
+        if (filename != "-")
         {
-            if (place.elevation < waterLevel)
+            outFile.open(filename);
+            if (outFile.is_open())
+            {
+                outFile << "level,flooded";
+                for (std::size_t id : table.placeIds)
+                {
+                    outFile << "," << csvField(placeById(id).name);
+                }
+                outFile << "\n";
+            }
+        }
 
+        std::cout << "\nInundation Table (" << levelCount << " levels x " << placeCount << " places):\n";
+        std::cout << std::setw(10) << "Level" << std::setw(10) << "Flooded" << std::setw(12) << "Max Depth" << "\n";
+        for (std::size_t first = 0; first < levelCount; first += blockLevels)
+        {
+            table.levels.resize(std::min(blockLevels, levelCount - first));
+            for (std::size_t l = 0; l < table.levels.size(); ++l)
             {
-                place.floodDepth = waterLevel - place.elevation;
-                std::cout << "Flood depth at " << place.name << " is " << place.floodDepth << "\n";
+                table.levels[l] = minLevel + (first + l) * step;
             }
-            else
+            fillInundationRows(table);
+
+            for (std::size_t l = 0; l < table.levels.size(); ++l)
             {
-                place.floodDepth = 0;
+                float maxDepth = 0;
+                for (std::size_t i = 0; i < placeCount; ++i)
+                {
+                    maxDepth = std::max(maxDepth, table.depth(l, i));
+                }
+                std::cout << std::setw(10) << table.levels[l] << std::setw(10) << table.floodedCounts[l] << std::setw(12) << maxDepth << "\n";
+                if (outFile.is_open())
+                {
+                    outFile << table.levels[l] << "," << table.floodedCounts[l];
+                    for (std::size_t i = 0; i < placeCount; ++i)
+                    {
+                        outFile << "," << table.depth(l, i);
+                    }
+                    outFile << "\n";
+                }
             }
         }
+
+        if (filename == "-")
+        {
+            return;
+        }
+        if (!outFile.is_open())
+        {
+            std::cerr << "Unable to open file for writing.\n";
+            return;
+        }
+        std::cout << "Inundation table saved to " << filename << ".\n";
     }
 
-    // Save the map to a file
-    void saveMapToFile(const std::string &filename)
+    // Simulate flood event
+    void simulateFloodEvent(float waterLevel)
     {
-        std::ofstream outFile(filename);
-        if (outFile.is_open())
+        std::cout << "\nSimulating flood event with water level: " << waterLevel << "\n";
+        calculateFloodDepth(waterLevel);
+        identifyFloodRiskZones();
+    }
+
+    // Track rescue details for a specific place
+    void trackRescueDetails(const std::string &placeName, int males, int females, int injured, int deaths)
+    {
+        RescueCounts counts{males + females, males, females, injured, deaths};
+        std::int64_t minute = currentMinute();
+        if (applyRescue(placeName, counts, minute))
         {
-            for (const auto &place : places)
-            {
-                outFile << place.name << " " << place.elevation << " " << place.floodDepth << " "
-                        << place.rescued << " " << place.maleRescued << " " << place.femaleRescued << " "
-                        << place.injured << " " << place.deaths << "\n";
-            }
-            outFile.close();
-            std::cout << "\nMap saved to " << filename << "\n";
+            WalRecord record;
+            record.type = WalRecordType::Rescue;
+            record.name = placeName;
+            record.counts = counts;
+            record.minute = minute;
+            logMutation(std::move(record));
+
+            std::cout << "Rescue details updated for " << placeName << ".\n";
         }
         else
         {
-            std::cerr << "\nUnable to open file for writing.\n";
+            std::cout << "Place " << placeName << " not found.\n";
         }
     }
 
-    // Print the map for visualization
-    void printMap()
+    // Record a rescue report for a place ID from any thread. IDs must be
+    // resolved (placeId) while no thread is adding or removing places.
+    void trackRescueDetailsConcurrent(std::size_t id, int males, int females, int injured, int deaths)
     {
-        std::cout << "\nPlace Elevation and Flood Depth:\n";
-        for (const auto &place : places)
-        {
-            std::cout << place.name << " - Elevation: " << std::setw(5) << place.elevation
-                      << " Flood Depth: " << std::setw(5) << place.floodDepth
-                      << " Rescued: " << place.rescued
-                      << " Injured: " << place.injured
-                      << " Deaths: " << place.deaths << "\n";
-        }
+        rescueTracker.record(id, {males + females, males, females, injured, deaths});
     }
 
-    // Analyze flood risk and count risk zones
-    void analyzeFloodRisk()
+    // ID of a named place, or NO_PLACE
+    std::size_t placeId(const std::string &name) const
     {
-        int riskCount = 0;
-        for ( const auto &place : places)
-        {
-            if (place.elevation < FLOOD_THRESHOLD)
-            {
-                riskCount++;
-            }
-        }
-        std::cout << "\nTotal flood risk zones identified: " << riskCount << "\n";
+        return nameIndex.find(name, placeName());
     }
 
-    // Display statistics about flood risk zones
-    void displayFloodRiskStatistics()
+    // Apply concurrent rescue reports made so far to the place counters and
+    // log each place's delta. Readers call this first so they see one
+    // consistent epoch; epochs reach the log in the order they were drained.
+    void publishRescueUpdates()
     {
-        int riskCount = 0;
-        float totalElevation = 0;
-        for (const auto &place : places)
+        std::int64_t minute = currentMinute();
+        std::vector<WalRecord> drained;
+        rescueTracker.drain([this, minute, &drained](std::size_t id, const RescueCounts &counts)
         {
-            if (place.elevation < FLOOD_THRESHOLD)
+            if (id >= positionOf.size() || positionOf[id] == NO_PLACE)
+            {
+                return;
+            }
+            Place &place = placeById(id);
+            place.rescued += counts.rescued;
+            place.maleRescued += counts.males;
+            place.femaleRescued += counts.females;
+            place.injured += counts.injured;
+            place.deaths += counts.deaths;
+            place.rescueHistory.append(minute, counts.rescued);
+            countRescues(counts, 1);
+            if (wal.isOpen())
             {
-                riskCount++;
-                totalElevation += place.elevation;
+                WalRecord record;
+                record.type = WalRecordType::Rescue;
+                record.name = place.name;
+                record.counts = counts;
+                record.minute = minute;
+                drained.push_back(std::move(record));
             }
+        });
 
+        for (auto &record : drained)
+        {
+            wal.append(std::move(record));
         }
-
-        float averageElevation = (riskCount > 0) ? (totalElevation / riskCount) : 0;
-        std::cout << "\nTotal flood risk zones: " << riskCount << "\n";
-        std::cout << "Average elevation of risk zones: " << averageElevation << "\n";
-
     }
 
-    // Find the nearest flood risk zone to a given place
-    void findNearestFloodRiskZone(const std::string &placeName)
+    // Simulate field teams reporting rescues at once while the dashboard
+    // keeps reading snapshots
+    void simulateConcurrentRescueReports(unsigned teams, std::size_t reportsPerTeam)
     {
-        auto it = std::find_if(places.begin(), places.end(), [&](const Place &place)
-                               { return place.name == placeName; });
-
-        if (it == places.end())
+        std::vector<std::size_t> ids;
+        for (const auto &place : places)
         {
-            std::cout << "\nPlace " << placeName << " not found.\n";
+            ids.push_back(place.id);
+        }
+        if (ids.empty() || teams == 0)
+        {
+            std::cout << "Nothing to simulate.\n";
             return;
         }
 
-        const Place &currentPlace = *it;
-        float minDistance = std::numeric_limits<float>::max();
-        std::string nearestPlace = "None";
-
+        publishRescueUpdates();
+        long long rescuedBefore = 0;
         for (const auto &place : places)
         {
-            if (place.elevation < FLOOD_THRESHOLD && place.name != currentPlace.name)
+            rescuedBefore += place.rescued;
+        }
+
+        std::atomic<bool> running{true};
+        std::size_t snapshots = 0;
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < teams; ++t)
+        {
+            workers.emplace_back([&, t]()
             {
-                float distance = std::abs(currentPlace.elevation - place.elevation);
-                if (distance < minDistance)
+                std::mt19937 rng(t + 1);
+                for (std::size_t r = 0; r < reportsPerTeam; ++r)
                 {
-                    minDistance = distance;
-                    nearestPlace = place.name;
+                    trackRescueDetailsConcurrent(ids[rng() % ids.size()], rng() % 3, rng() % 3, rng() % 2, 0);
                 }
-            }
+            });
         }
-
-        if (nearestPlace != "None")
+        std::thread dashboard([&]()
+        {
+            while (running.load())
+            {
+                publishRescueUpdates();
+                ++snapshots;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+        for (auto &worker : workers)
         {
-            std::cout << "\nNearest flood risk zone to " << placeName << " is " << nearestPlace << "\n";
+            worker.join();
         }
-        else
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        running = false;
+        dashboard.join();
+        publishRescueUpdates();
+
+        long long rescuedAfter = 0;
+        for (const auto &place : places)
         {
-            std::cout << "\nNo flood risk zones found.\n";
+            rescuedAfter += place.rescued;
         }
+        std::size_t reports = teams * reportsPerTeam;
+        std::cout << "\n" << reports << " reports from " << teams << " teams in " << seconds << " s ("
+                  << static_cast<long long>(reports / std::max(seconds, 1e-9)) << " updates/s), "
+                  << snapshots << " snapshots taken meanwhile.\n";
+        std::cout << "People rescued in simulation: " << rescuedAfter - rescuedBefore << "\n";
     }
 
-    // Simulate flood event
-    void simulateFloodEvent(float waterLevel)
+    // Report rescues at a place between two times, inclusive
+    void queryRescueHistory(const std::string &placeName, std::int64_t from, std::int64_t to)
     {
-        std::cout << "\nSimulating flood event with water level: " << waterLevel << "\n";
-        calculateFloodDepth(waterLevel);
-        identifyFloodRiskZones();
+        publishRescueUpdates();
+        Place *place = findPlace(placeName);
+        if (place == nullptr)
+        {
+            std::cout << "Place " << placeName << " not found.\n";
+            return;
+        }
+
+        SeriesSummary summary = place->rescueHistory.range(from, to);
+        std::cout << "\nRescues at " << placeName << " from " << formatMinute(from) << " to " << formatMinute(to) << ":\n";
+        std::cout << "Total Rescued: " << summary.sum << "\n";
+        std::cout << "Minutes with reports: " << summary.points << "\n";
+        if (summary.points > 0)
+        {
+            std::cout << "Most rescued in one minute: " << summary.max << "\n";
+            std::cout << "Fewest rescued in one minute: " << summary.min << "\n";
+        }
     }
 
-    // Track rescue details for a specific place
-    void trackRescueDetails(const std::string &placeName, int males, int females, int injured, int deaths)
+    // Replace every place's rescue history with sample minute-level counts
+    // for the given number of days up to now. The rescue totals are left as
+    // they are; a checkpoint makes the new history durable.
+    void generateSampleRescueHistory(int days)
     {
-        auto it = std::find_if(places.begin(), places.end(), [&](const Place &place) { return place.name == placeName; });
-        if (it != places.end())
+        if (days <= 0)
         {
-            it->maleRescued += males;
-            it->femaleRescued += females;
-            it->rescued += (males + females);
-            it->injured += injured;
-            it->deaths += deaths;
-
-            std::cout << "Rescue details updated for " << placeName << ".\n";
+            std::cout << "Number of days must be positive.\n";
+            return;
         }
-        else
+
+        auto start = std::chrono::steady_clock::now();
+        std::int64_t last = currentMinute(), first = last - static_cast<std::int64_t>(days) * 24 * 60 + 1;
+        std::mt19937 rng(42);
+        std::size_t points = 0, bytes = 0;
+        for (auto &place : places)
         {
-            std::cout << "Place " << placeName << " not found.\n";
+            place.rescueHistory.clear();
+            for (std::int64_t minute = first; minute <= last; ++minute)
+            {
+                place.rescueHistory.append(minute, static_cast<std::int32_t>(rng() % 4));
+            }
+            points += place.rescueHistory.size();
+            bytes += place.rescueHistory.memoryUsage();
         }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "\nGenerated " << points << " minutes of rescue history for " << places.size() << " places from "
+                  << formatMinute(first) << " in " << seconds << " s.\n";
+        std::cout << "Memory used: " << bytes / 1024 << " KB (" << (points > 0 ? static_cast<double>(bytes) / points : 0)
+                  << " bytes per minute).\n";
+        unloggedChanges = true;
+        checkpoint();
     }
 
     // Display rescue statistics for all places
     void displayRescueStatistics()
     {
+        publishRescueUpdates();
 
         std::cout << "\nRescue Statistics:\n";
         std::cout << std::setw(15) << "Place"
@@ -269,23 +2973,13 @@ public:
    // Analyze rescue operations
 void analyzeRescueOperations()
 {
+    publishRescueUpdates();
 
-    int totalRescued = 0;
-    int totalMales = 0;
-    int totalFemales = 0;
-    int totalInjured = 0;
-    int totalDeaths = 0;
-    for (const auto &place : places)
-
-    {
-        // Corrected line
-        totalRescued += place.rescued;
-        totalMales += place.maleRescued;
-        totalFemales += place.femaleRescued;
-        totalInjured += place.injured;
-        totalDeaths += place.deaths;
-
-    }
+    long long totalRescued = aggregates.rescued;
+    long long totalMales = aggregates.males;
+    long long totalFemales = aggregates.females;
+    long long totalInjured = aggregates.injured;
+    long long totalDeaths = aggregates.deaths;
 
     std::cout << "\nRescue Operation Summary:\n";
     std::cout << "Total Rescued: " << totalRescued << "\n";
@@ -305,9 +2999,16 @@ void analyzeRescueOperations()
     // Sort places by elevation
     void sortPlacesByElevation()
     {
-        std::sort(places.begin(), places.end(), [](const Place &a, const Place &b) {
-            return a.elevation < b.elevation;
-        });
+        // The elevation index already holds the order, so this is a permutation
+        std::vector<Place> sorted;
+        sorted.reserve(places.size());
+        for (std::size_t id : byElevation().orderedIds())
+        {
+            sorted.push_back(std::move(placeById(id)));
+        }
+        places.swap(sorted);
+        updatePositions();
+        unloggedChanges = true;
 
         std::cout << "\nPlaces sorted by elevation.\n";
     }
@@ -318,16 +3019,21 @@ void analyzeRescueOperations()
         std::sort(places.begin(), places.end(), [](const Place &a, const Place &b) {
             return a.floodDepth < b.floodDepth;
         });
+        updatePositions();
+        unloggedChanges = true;
         std::cout << "\nPlaces sorted by flood depth.\n";
     }
 
     // Export rescue statistics to a file
     void exportRescueStatistics(const std::string &filename)
     {
+        publishRescueUpdates();
         std::ofstream outFile(filename);
         if (outFile.is_open())
         {
-            outFile << std::setw(15) << "Place"
+            // The header is a # comment and names are quoted as in a saved map,
+            // so loadRescueStatisticsFromFile reads the file back unchanged
+            outFile << "#" << std::setw(14) << "Place"
                     << std::setw(10) << "Rescued"
                     << std::setw(10) << "Males"
                     << std::setw(10) << "Females"
@@ -335,7 +3041,7 @@ void analyzeRescueOperations()
                     << std::setw(10) << "Deaths" << "\n";
             for (const auto &place : places)
             {
-                outFile << std::setw(15) << place.name
+                outFile << std::setw(15) << quoteName(place.name)
                         << std::setw(10) << place.rescued
                         << std::setw(10) << place.maleRescued
                         << std::setw(10) << place.femaleRescued
@@ -358,9 +3064,14 @@ void analyzeRescueOperations()
         float waterLevel;
         std::string filename, placeName;
         int males, females, injured, deaths;
+        double latitude, longitude, radius;
+        float minLevel, maxLevel, step;
+        std::size_t count, reports;
+        int days;
 
         do
         {
+            compactLogIfLong();
             displayMainMenu();
             std::cin >> choice;
 
@@ -414,7 +3125,9 @@ void analyzeRescueOperations()
                 float elevation;
  std::cout << "Enter elevation for " << placeName << ": ";
                 std::cin >> elevation;
-                addPlace(placeName, elevation);
+                std::cout << "Enter latitude and longitude for " << placeName << ": ";
+                std::cin >> latitude >> longitude;
+                addPlace(placeName, elevation, latitude, longitude);
                 break;
 
             case 10:
@@ -519,7 +3232,78 @@ void analyzeRescueOperations()
                 loadRescueStatisticsFromFile(filename);
                 break;
 
+            case 26:
+                std::cout << "Enter place name to find nearest flood risk zones: ";
+                std::cin.ignore();
+                std::getline(std::cin, placeName);
+                std::cout << "Enter number of zones: ";
+                std::cin >> count;
+                findNearestFloodRiskZones(placeName, count);
+                break;
+
+            case 27:
+                std::cout << "Enter place name to search around: ";
+                std::cin.ignore();
+                std::getline(std::cin, placeName);
+                std::cout << "Enter radius (km): ";
+                std::cin >> radius;
+                findPlacesWithinRadius(placeName, radius);
+                break;
+
+            case 28:
+                std::cout << "Enter lowest water level, highest water level and step: ";
+                std::cin >> minLevel >> maxLevel >> step;
+                std::cout << "Enter filename to save table (- to skip): ";
+                std::cin >> filename;
+                generateInundationTable(minLevel, maxLevel, step, filename);
+                break;
+
+            case 29:
+                std::cout << "Enter filename to save snapshot: ";
+                std::cin >> filename;
+                saveSnapshot(filename);
+                break;
+
+            case 30:
+                std::cout << "Enter filename to load snapshot: ";
+                std::cin >> filename;
+                loadSnapshot(filename);
+                break;
+
+            case 31:
+                std::cout << "Enter number of field teams and reports per team: ";
+                std::cin >> count >> reports;
+                simulateConcurrentRescueReports(static_cast<unsigned>(count), reports);
+                break;
+
+            case 32:
+            {
+                std::string fromText, toText;
+                std::int64_t from, to;
+                std::cout << "Enter place name for rescue history: ";
+                std::cin.ignore();
+                std::getline(std::cin, placeName);
+                std::cout << "Enter start time (YYYY-MM-DD HH:MM): ";
+                std::getline(std::cin, fromText);
+                std::cout << "Enter end time (YYYY-MM-DD HH:MM): ";
+                std::getline(std::cin, toText);
+                if (!parseMinute(fromText, from) || !parseMinute(toText, to))
+                {
+                    std::cout << "Invalid time. Use YYYY-MM-DD HH:MM.\n";
+                    break;
+                }
+                queryRescueHistory(placeName, from, to);
+                break;
+            }
+
+            case 33:
+                std::cout << "Enter number of days of sample rescue history: ";
+                std::cin >> days;
+                generateSampleRescueHistory(days);
+                break;
+
             case 0:
+                checkpoint();
                 std::cout << "\nExiting program.\n";
                 break;
 
@@ -560,6 +3344,14 @@ void analyzeRescueOperations()
         std::cout << "23. Filter Places by Elevation\n";
         std::cout << "24. Reset Place Statistics\n";
         std::cout << "25. Load Rescue Statistics from File\n";
+        std::cout << "26. Find K Nearest Flood Risk Zones\n";
+        std::cout << "27. Find Places Within Radius\n";
+        std::cout << "28. Generate Inundation Table\n";
+        std::cout << "29. Save Binary Snapshot\n";
+        std::cout << "30. Load Binary Snapshot\n";
+        std::cout << "31. Simulate Concurrent Field Reports\n";
+        std::cout << "32. Rescues Between Times\n";
+        std::cout << "33. Generate Sample Rescue History\n";
         std::cout << "0. Exit\n";
         std::cout << "Enter your choice: ";
 
@@ -568,15 +3360,13 @@ void analyzeRescueOperations()
     // Reset statistics for a specific place
     void resetPlaceStatistics(const std::string &name)
     {
-        auto it = std::find_if(places.begin(), places.end(), [&](const Place &place) { return place.name == name; });
-        if (it != places.end())
+        publishRescueUpdates();
+        if (applyResetStatistics(name))
         {
-
-            it->rescued = 0;
-            it->maleRescued = 0;
-            it->femaleRescued = 0;
-            it->injured = 0;
-            it->deaths = 0;
+            WalRecord record;
+            record.type = WalRecordType::ResetStatistics;
+            record.name = name;
+            logMutation(std::move(record));
             std::cout << "Statistics reset for " << name << ".\n";
 
         }
@@ -590,48 +3380,73 @@ void analyzeRescueOperations()
 
     void loadRescueStatisticsFromFile(const std::string &filename)
     {
-        std::ifstream inFile(filename);
-        if (inFile.is_open())
+        publishRescueUpdates();
+        MappedFile file;
+        if (!file.open(filename))
         {
+            std::cerr << "Unable to open file for reading.\n";
+            return;
+        }
 
+        // Each line: name rescued males females injured deaths
+        struct RescueRecord
+        {
+            std::size_t id;
             std::string name;
             int rescued, males, females, injured, deaths;
-            while (inFile >> name >> rescued >> males >> females >> injured >> deaths)
+        };
+        std::size_t malformed = 0;
+        auto chunks = parseLinesInParallel<RescueRecord>(file, [this](const char *p, const char *end, RescueRecord &record)
+        {
+            if (!parseName(p, end, record.name) || !parseNumber(p, end, record.rescued) || !parseNumber(p, end, record.males)
+                || !parseNumber(p, end, record.females) || !parseNumber(p, end, record.injured) || !parseNumber(p, end, record.deaths))
             {
+                return false;
+            }
+            record.id = nameIndex.find(record.name, placeName());
+            return true;
+        }, malformed);
 
-                auto it = std::find_if(places.begin(), places.end(), [&](const Place &place) { return place.name == name; });
-                if (it != places.end())
-                {
-
-                    it->rescued = rescued;
-                    it->maleRescued = males;
-                    it->femaleRescued = females;
-                    it->injured = injured;
-                    it->deaths = deaths;
-
-                }
-
-                else
-
+        std::size_t loaded = 0, unknown = 0;
+        for (const auto &chunk : chunks)
+        {
+            for (const auto &record : chunk)
+            {
+                if (record.id == NO_PLACE)
                 {
-                    std::cout << "Place " << name << " not found in the map.\n";
+                    if (unknown++ < 10)
+                    {
+                        std::cout << "Place " << record.name << " not found in the map.\n";
+                    }
+                    continue;
                 }
-
+                Place &place = placeById(record.id);
+                countPlace(place, -1);
+                place.rescued = record.rescued;
+                place.maleRescued = record.males;
+                place.femaleRescued = record.females;
+                place.injured = record.injured;
+                place.deaths = record.deaths;
+                countPlace(place, 1);
+                ++loaded;
             }
-            inFile.close();
-            std::cout << "Rescue statistics loaded from " << filename << ".\n";
-
         }
-        else
-
+        unloggedChanges = true;
+        checkpoint();
+        std::cout << "Rescue statistics loaded from " << filename << ": " << loaded << " records";
+        if (unknown > 0)
         {
-            std::cerr << "Unable to open file for reading.\n";
+            std::cout << ", " << unknown << " for unknown places";
         }
-
+        if (malformed > 0)
+        {
+            std::cout << ", " << malformed << " malformed lines skipped";
+        }
+        std::cout << ".\n";
     }
 
     // Add a new place
-    void addPlace(const std::string &name, float elevation)
+    void addPlace(const std::string &name, float elevation, double latitude = 0, double longitude = 0)
 
     {
         if (elevation < 0)
@@ -641,7 +3456,19 @@ void analyzeRescueOperations()
             return;
         }
 
-        places.emplace_back(name, elevation);
+        if (!applyAddPlace(name, elevation, latitude, longitude))
+        {
+            std::cout << "Place " << name << " already exists. Place not added.\n";
+            return;
+        }
+
+        WalRecord record;
+        record.type = WalRecordType::AddPlace;
+        record.name = name;
+        record.elevation = elevation;
+        record.latitude = latitude;
+        record.longitude = longitude;
+        logMutation(std::move(record));
         std::cout << "Place " << name << " added with elevation " << elevation << ".\n";
     }
 
@@ -650,11 +3477,15 @@ void analyzeRescueOperations()
     void removePlace(const std::string &name)
 
     {
-        auto it = std::remove_if(places.begin(), places.end(), [&](const Place &place) { return place.name == name; });
-        if (it != places.end())
+        // Pending concurrent reports name places by ID, and the ID is about to be freed
+        publishRescueUpdates();
+        if (applyRemovePlace(name))
 
         {
-            places.erase(it, places.end());
+            WalRecord record;
+            record.type = WalRecordType::RemovePlace;
+            record.name = name;
+            logMutation(std::move(record));
             std::cout << "Place " << name << " removed from the map.\n";
         }
         else
@@ -669,31 +3500,87 @@ void analyzeRescueOperations()
 
     void loadPlacesFromFile(const std::string &filename)
     {
-
-        std::ifstream inFile(filename);
-        if (inFile.is_open())
+        MappedFile file;
+        if (!file.open(filename))
         {
+            std::cerr << "Unable to open file for reading.\n";
+            return;
+        }
 
+        // Each line: name elevation [latitude longitude]; names may be quoted
+        std::size_t malformed = 0;
+        auto chunks = parseLinesInParallel<Place>(file, [](const char *p, const char *end, Place &place)
+        {
             std::string name;
-            float elevation;
-            while (inFile >> name >> elevation)
-
+            if (!parseName(p, end, name))
             {
-                addPlace(name, elevation);
+                return false;
             }
-
-            inFile.close();
-            std::cout << "Places loaded from " << filename << ".\n";
+            place = Place(name);
+            if (!parseNumber(p, end, place.elevation) || place.elevation < 0)
+            {
+                return false;
+            }
+            skipBlanks(p, end);
+            if (p < end && (!parseNumber(p, end, place.latitude) || !parseNumber(p, end, place.longitude)))
+            {
+                return false;
+            }
+            return true;
+        }, malformed);
+
+        std::size_t added = appendPlaces(chunks);
+        // Bulk loads are not logged record by record; snapshot them instead
+        unloggedChanges = true;
+        checkpoint();
+        std::cout << "Places loaded from " << filename << ": " << added << " added";
+        if (malformed > 0)
+        {
+            std::cout << ", " << malformed << " malformed lines skipped";
         }
+        std::cout << ".\n";
+    }
 
-        else
-
+    // Append batches of new places with a single reservation, skipping names
+    // already on the map, then rebuild the spatial and elevation indexes once.
+    // Returns the number of places added.
+    std::size_t appendPlaces(std::vector<std::vector<Place>> &batches)
+    {
+        std::size_t total = 0;
+        for (const auto &batch : batches)
         {
+            total += batch.size();
+        }
+        places.reserve(places.size() + total);
+        positionOf.reserve(positionOf.size() + total);
+        nameIndex.reserve(places.size() + total);
 
-            std::cerr << "Unable to open file for reading.\n";
-
+        std::size_t added = 0, duplicates = 0;
+        for (auto &batch : batches)
+        {
+            for (auto &place : batch)
+            {
+                places.push_back(std::move(place));
+                std::size_t id = takeId(places.size() - 1);
+                places.back().id = id;
+                if (!nameIndex.insert(places.back().name, id, placeName()))
+                {
+                    places.pop_back();
+                    releaseId(id);
+                    ++duplicates;
+                    continue;
+                }
+                countPlace(places.back(), 1);
+                ++added;
+            }
+        }
+        if (duplicates > 0)
+        {
+            std::cout << duplicates << " places already on the map were skipped.\n";
         }
 
+        orderIndexesBuilt = false;
+        return added;
     }
 
     // Save places to a file
@@ -708,7 +3595,7 @@ void analyzeRescueOperations()
             for (const auto &place : places)
 
             {
-                outFile << place.name << " " << place.elevation << "\n";
+                outFile << quoteName(place.name) << " " << place.elevation << " " << place.latitude << " " << place.longitude << "\n";
             }
 
             outFile.close();
@@ -723,6 +3610,32 @@ void analyzeRescueOperations()
 
     }
 
+    // Write all places as a binary snapshot. The file is written under a
+    // temporary name and renamed, so an existing snapshot is never left torn.
+    void saveSnapshot(const std::string &filename)
+    {
+        publishRescueUpdates();
+        if (writeSnapshot(filename, wal.lastSequence()))
+        {
+            std::cout << "Snapshot of " << places.size() << " places saved to " << filename << ".\n";
+        }
+    }
+
+    // Replace all places with the contents of a binary snapshot
+    void loadSnapshot(const std::string &filename)
+    {
+        publishRescueUpdates();
+        std::uint64_t walSequence;
+        if (!readSnapshot(filename, walSequence))
+        {
+            std::cerr << "Unable to open snapshot " << filename << ".\n";
+            return;
+        }
+        unloggedChanges = true;
+        checkpoint();
+        std::cout << "Snapshot of " << places.size() << " places loaded from " << filename << ".\n";
+    }
+
     // Display all places
 
     void displayAllPlaces()
@@ -732,7 +3645,8 @@ void analyzeRescueOperations()
         for (const auto &place : places )
 
         {
-            std::cout << place.name << " - Elevation: " << place.elevation << "\n";
+            std::cout << place.name << " - Elevation: " << place.elevation
+                      << " Location: " << place.latitude << ", " << place.longitude << "\n";
         }
 
     }
@@ -742,12 +3656,12 @@ void analyzeRescueOperations()
     void findPlaceByName(const std::string &name)
 
     {
-        auto it = std::find_if(places.begin(), places.end(), [&](const Place &place) { return place.name == name; });
-        if (it != places.end())
+        Place *place = findPlace(name);
+        if (place != nullptr)
 
         {
 
-            std::cout << "Found: " << it->name << " - Elevation: " << it->elevation << "\n";
+            std::cout << "Found: " << place->name << " - Elevation: " << place->elevation << "\n";
 
         }
         else
@@ -768,11 +3682,14 @@ void analyzeRescueOperations()
             return;
         }
 
-        auto it = std::find_if(places.begin(), places.end(), [&](const Place &place) { return place.name == name; });
-        if (it != places.end())
+        if (applyElevation(name, newElevation))
 
         {
-            it->elevation = newElevation;
+            WalRecord record;
+            record.type = WalRecordType::Elevation;
+            record.name = name;
+            record.elevation = newElevation;
+            logMutation(std::move(record));
             std::cout << "Updated elevation of " << name << " to " << newElevation << ".\n";
 
         }
@@ -788,19 +3705,20 @@ void analyzeRescueOperations()
 
     void displayDetailedStatistics(const std::string &placeName)
     {
+        publishRescueUpdates();
 
-        auto it = std::find_if(places.begin(), places.end(), [&](const Place &place) { return place.name == placeName; });
-        if (it != places.end())
+        Place *place = findPlace(placeName);
+        if (place != nullptr)
         {
 
-            std::cout << "\nDetailed Statistics for " << it->name << ":\n";
-            std::cout << "Elevation: " << it->elevation << "\n";
-            std::cout << "Flood Depth: " << it->floodDepth << "\n";
-            std::cout << "Total Rescued: " << it->rescued << "\n";
-            std::cout << "Males Rescued: " << it->maleRescued << "\n";
-            std::cout << "Females Rescued: " << it->femaleRescued << "\n";
-            std::cout << "Injured: " << it->injured << "\n";
-            std::cout << "Deaths: " << it->deaths << "\n";
+            std::cout << "\nDetailed Statistics for " << place->name << ":\n";
+            std::cout << "Elevation: " << place->elevation << "\n";
+            std::cout << "Flood Depth: " << place->floodDepth << "\n";
+            std::cout << "Total Rescued: " << place->rescued << "\n";
+            std::cout << "Males Rescued: " << place->maleRescued << "\n";
+            std::cout << "Females Rescued: " << place->femaleRescued << "\n";
+            std::cout << "Injured: " << place->injured << "\n";
+            std::cout << "Deaths: " << place->deaths << "\n";
 
         }
         else
@@ -817,14 +3735,11 @@ void analyzeRescueOperations()
     {
 
         std::cout << "\nPlaces with elevation below " << threshold << ":\n";
-        for (const auto &place : places)
+        std::size_t count = byElevation().countBelow(threshold);
+        for (std::size_t rank = 0; rank < count; ++rank)
         {
-
-            if (place.elevation < threshold)
-            {
-                std::cout << place.name << " - Elevation: " << place.elevation << "\n";
-            }
-
+            const Place &place = placeById(byElevation().orderedIds()[rank]);
+            std::cout << place.name << " - Elevation: " << place.elevation << "\n";
         }
     }
 };